@@ -0,0 +1,54 @@
+#include <pajlada/signals/connection.hpp>
+#include <pajlada/signals/signal.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace pajlada::Signals;
+
+namespace {
+
+void
+BM_Connection_IsBlocked(benchmark::State &state)
+{
+    Signal<int> signal;
+    auto conn = signal.connect([](int) {});
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conn.isBlocked());
+    }
+
+    conn.disconnect();
+}
+
+void
+BM_Connection_IsConnected(benchmark::State &state)
+{
+    Signal<int> signal;
+    auto conn = signal.connect([](int) {});
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conn.isConnected());
+    }
+
+    conn.disconnect();
+}
+
+void
+BM_Connection_Copy(benchmark::State &state)
+{
+    Signal<int> signal;
+    auto conn = signal.connect([](int) {});
+
+    for (auto _ : state) {
+        Connection copy(conn);
+        copy.disconnect();
+    }
+
+    conn.disconnect();
+}
+
+}  // namespace
+
+BENCHMARK(BM_Connection_IsBlocked);
+BENCHMARK(BM_Connection_IsConnected);
+BENCHMARK(BM_Connection_Copy);
@@ -0,0 +1,78 @@
+#include <pajlada/signals/dense-signal.hpp>
+#include <pajlada/signals/signal.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using namespace pajlada::Signals;
+
+namespace {
+
+constexpr int64_t LISTENER_COUNT = 100000;
+
+// state.range(0) is the percentage of blocked listeners
+template <typename SignalType>
+void
+invokeWithBlocked(benchmark::State &state, SignalType &signal)
+{
+    int64_t sum = 0;
+    std::vector<Connection> connections;
+    connections.reserve(LISTENER_COUNT);
+    for (int64_t i = 0; i < LISTENER_COUNT; ++i) {
+        connections.emplace_back(signal.connect([&sum](int value) {
+            sum += value;
+        }));
+    }
+
+    // Spread the blocked listeners evenly
+    int64_t blocked = 0;
+    for (int64_t i = 0; i < LISTENER_COUNT; ++i) {
+        if ((i + 1) * state.range(0) / 100 > blocked) {
+            connections[i].block();
+            ++blocked;
+        }
+    }
+
+    for (auto _ : state) {
+        signal.invoke(1);
+    }
+
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * LISTENER_COUNT);
+
+    for (auto &connection : connections) {
+        connection.disconnect();
+    }
+}
+
+void
+BM_Signal_InvokeBlocked(benchmark::State &state)
+{
+    Signal<int> signal;
+
+    invokeWithBlocked(state, signal);
+}
+
+void
+BM_Signal_InPlaceInvokeBlocked(benchmark::State &state)
+{
+    Signal<int> signal;
+    signal.setEmitStrategy(EmitStrategy::InPlace);
+
+    invokeWithBlocked(state, signal);
+}
+
+void
+BM_DenseSignal_InvokeBlocked(benchmark::State &state)
+{
+    DenseSignal<int> signal;
+
+    invokeWithBlocked(state, signal);
+}
+
+}  // namespace
+
+BENCHMARK(BM_Signal_InvokeBlocked)->Arg(0)->Arg(50)->Arg(90)->Arg(99);
+BENCHMARK(BM_Signal_InPlaceInvokeBlocked)->Arg(0)->Arg(50)->Arg(90)->Arg(99);
+BENCHMARK(BM_DenseSignal_InvokeBlocked)->Arg(0)->Arg(50)->Arg(90)->Arg(99);
@@ -0,0 +1,48 @@
+#include <pajlada/signals/signal.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using namespace pajlada::Signals;
+
+namespace {
+
+void
+invokeWithStrategy(benchmark::State &state, EmitStrategy strategy)
+{
+    Signal<int> signal;
+    signal.setEmitStrategy(strategy);
+
+    int64_t sum = 0;
+    std::vector<Connection> connections;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        connections.emplace_back(signal.connect([&sum](int value) {
+            sum += value;
+        }));
+    }
+
+    for (auto _ : state) {
+        signal.invoke(1);
+    }
+
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void
+BM_Signal_InvokeSnapshot(benchmark::State &state)
+{
+    invokeWithStrategy(state, EmitStrategy::Snapshot);
+}
+
+void
+BM_Signal_InvokeInPlace(benchmark::State &state)
+{
+    invokeWithStrategy(state, EmitStrategy::InPlace);
+}
+
+}  // namespace
+
+BENCHMARK(BM_Signal_InvokeSnapshot)->RangeMultiplier(8)->Range(1, 4096);
+BENCHMARK(BM_Signal_InvokeInPlace)->RangeMultiplier(8)->Range(1, 4096);
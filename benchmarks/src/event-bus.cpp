@@ -0,0 +1,86 @@
+#include <pajlada/signals/event-bus.hpp>
+#include <pajlada/signals/signal.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <any>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+
+using namespace pajlada::Signals;
+
+namespace {
+
+struct Tick {
+    int value;
+};
+
+// The hand-rolled hub EventBus replaces
+class AnyMapBus
+{
+public:
+    template <typename Event, typename Callback>
+    Connection
+    subscribe(Callback &&func)
+    {
+        auto &entry = this->signals[std::type_index(typeid(Event))];
+        if (!entry.has_value()) {
+            entry = std::make_shared<Signal<const Event &>>();
+        }
+
+        return std::any_cast<std::shared_ptr<Signal<const Event &>> &>(entry)
+            ->connect(std::forward<Callback>(func));
+    }
+
+    template <typename Event>
+    void
+    publish(const Event &event)
+    {
+        auto it = this->signals.find(std::type_index(typeid(Event)));
+        if (it == this->signals.end()) {
+            return;
+        }
+
+        std::any_cast<std::shared_ptr<Signal<const Event &>> &>(it->second)
+            ->invoke(event);
+    }
+
+private:
+    std::unordered_map<std::type_index, std::any> signals;
+};
+
+template <typename Bus>
+void
+publish(benchmark::State &state)
+{
+    Bus bus;
+    int64_t sum = 0;
+
+    auto conn = bus.template subscribe<Tick>([&sum](const Tick &tick) {
+        sum += tick.value;
+    });
+
+    for (auto _ : state) {
+        bus.publish(Tick{1});
+    }
+
+    benchmark::DoNotOptimize(sum);
+}
+
+void
+BM_AnyMapBus_Publish(benchmark::State &state)
+{
+    publish<AnyMapBus>(state);
+}
+
+void
+BM_EventBus_Publish(benchmark::State &state)
+{
+    publish<EventBus>(state);
+}
+
+}  // namespace
+
+BENCHMARK(BM_AnyMapBus_Publish);
+BENCHMARK(BM_EventBus_Publish);
@@ -0,0 +1,56 @@
+#include <pajlada/signals/signal.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using namespace pajlada::Signals;
+
+namespace {
+
+template <bool Nothrow>
+void
+invokeWithPolicy(benchmark::State &state, ExceptionPolicy policy)
+{
+    Signal<int> signal;
+    signal.setExceptionPolicy(policy);
+    int64_t sum = 0;
+
+    std::vector<Connection> connections;
+    for (int i = 0; i < 16; ++i) {
+        connections.emplace_back(
+            signal.connect([&sum](int value) noexcept(Nothrow) {
+                sum += value;
+            }));
+    }
+
+    for (auto _ : state) {
+        signal.invoke(1);
+    }
+
+    benchmark::DoNotOptimize(sum);
+}
+
+void
+BM_Invoke_Propagate(benchmark::State &state)
+{
+    invokeWithPolicy<false>(state, ExceptionPolicy::Propagate);
+}
+
+void
+BM_Invoke_Report(benchmark::State &state)
+{
+    invokeWithPolicy<false>(state, ExceptionPolicy::Report);
+}
+
+void
+BM_Invoke_Report_Noexcept(benchmark::State &state)
+{
+    invokeWithPolicy<true>(state, ExceptionPolicy::Report);
+}
+
+}  // namespace
+
+BENCHMARK(BM_Invoke_Propagate);
+BENCHMARK(BM_Invoke_Report);
+BENCHMARK(BM_Invoke_Report_Noexcept);
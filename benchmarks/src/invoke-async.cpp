@@ -0,0 +1,92 @@
+#include <pajlada/signals/signal.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <functional>
+#include <future>
+#include <vector>
+
+using namespace pajlada::Signals;
+
+namespace {
+
+// The tasks are queued and then run on the same thread, so only the cost of
+// the completion tracking is measured
+void
+BM_InvokeAsync(benchmark::State &state)
+{
+    Signal<int> signal;
+    int64_t sum = 0;
+
+    std::vector<Connection> connections;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        connections.emplace_back(signal.connect([&sum](int value) {
+            sum += value;
+        }));
+    }
+
+    std::vector<MoveOnlyFunction<void()>> tasks;
+    tasks.reserve(state.range(0));
+
+    for (auto _ : state) {
+        auto completion = signal.invokeAsync(
+            [&tasks](auto task) {
+                tasks.emplace_back(std::move(task));
+            },
+            1);
+
+        for (auto &task : tasks) {
+            task();
+        }
+        tasks.clear();
+
+        completion.wait();
+    }
+
+    benchmark::DoNotOptimize(sum);
+}
+
+// The same with a std::future per listener
+void
+BM_InvokeFuturePerListener(benchmark::State &state)
+{
+    std::vector<std::function<void(int)>> listeners;
+    int64_t sum = 0;
+
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        listeners.emplace_back([&sum](int value) {
+            sum += value;
+        });
+    }
+
+    std::vector<std::packaged_task<void()>> tasks;
+    std::vector<std::future<void>> futures;
+    tasks.reserve(state.range(0));
+    futures.reserve(state.range(0));
+
+    for (auto _ : state) {
+        for (auto &listener : listeners) {
+            tasks.emplace_back([&listener] {
+                listener(1);
+            });
+            futures.emplace_back(tasks.back().get_future());
+        }
+
+        for (auto &task : tasks) {
+            task();
+        }
+        tasks.clear();
+
+        for (auto &future : futures) {
+            future.wait();
+        }
+        futures.clear();
+    }
+
+    benchmark::DoNotOptimize(sum);
+}
+
+}  // namespace
+
+BENCHMARK(BM_InvokeAsync)->Arg(1)->Arg(16)->Arg(256);
+BENCHMARK(BM_InvokeFuturePerListener)->Arg(1)->Arg(16)->Arg(256);
@@ -0,0 +1,98 @@
+#include <pajlada/signals/operators.hpp>
+#include <pajlada/signals/signal.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace pajlada::Signals;
+
+namespace {
+
+// The same 5 stages, once as signals re-emitting into each other and once
+// as a fused pipeline
+
+void
+BM_Operators_ChainedSignals(benchmark::State &state)
+{
+    Signal<int> source;
+    Signal<int> filtered;
+    Signal<int> mapped;
+    Signal<int> distinct;
+    Signal<int> scanned;
+    Signal<int> taken;
+
+    int last = -1;
+    int total = 0;
+    int64_t remaining = INT64_MAX;
+    int64_t sink = 0;
+
+    auto c1 = source.connect([&](int v) {
+        if (v % 4 != 3) {
+            filtered.invoke(v);
+        }
+    });
+    auto c2 = filtered.connect([&](int v) {
+        mapped.invoke(v / 2);
+    });
+    auto c3 = mapped.connect([&](int v) {
+        if (v != last) {
+            last = v;
+            distinct.invoke(v);
+        }
+    });
+    auto c4 = distinct.connect([&](int v) {
+        total += v;
+        scanned.invoke(total);
+    });
+    auto c5 = scanned.connect([&](int v) {
+        if (remaining > 0) {
+            --remaining;
+            taken.invoke(v);
+        }
+    });
+    auto c6 = taken.connect([&](int v) {
+        sink += v;
+    });
+
+    int i = 0;
+    for (auto _ : state) {
+        source.invoke(i++);
+    }
+
+    benchmark::DoNotOptimize(sink);
+}
+
+void
+BM_Operators_FusedPipeline(benchmark::State &state)
+{
+    Signal<int> source;
+    int64_t sink = 0;
+
+    auto conn = pipe(source)
+                    .filter([](int v) {
+                        return v % 4 != 3;
+                    })
+                    .map([](int v) {
+                        return v / 2;
+                    })
+                    .distinct()
+                    .scan(0,
+                          [](int total, int v) {
+                              return total + v;
+                          })
+                    .take(INT64_MAX)
+                    .connect([&](int v) {
+                        sink += v;
+                    });
+
+    int i = 0;
+    for (auto _ : state) {
+        source.invoke(i++);
+    }
+
+    benchmark::DoNotOptimize(sink);
+}
+
+}  // namespace
+
+BENCHMARK(BM_Operators_ChainedSignals);
+BENCHMARK(BM_Operators_FusedPipeline);
@@ -0,0 +1,85 @@
+#include <pajlada/signals/signal.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <vector>
+
+using namespace pajlada::Signals;
+
+namespace {
+
+// The SelfDisconnectingSignal implementation prior to the rework, kept
+// around to compare against
+template <class... Args>
+class LegacySelfDisconnectingSignal
+{
+    typedef std::function<bool(Args...)> CallbackType;
+
+public:
+    void
+    connect(CallbackType cb)
+    {
+        this->callbacks.push_back(std::move(cb));
+    }
+
+    void
+    invoke(Args... args)
+    {
+        callbacks.erase(std::remove_if(callbacks.begin(), callbacks.end(),
+                                       [&](CallbackType callback) {
+                                           return callback(args...);
+                                       }),
+                        callbacks.end());
+    }
+
+private:
+    std::vector<CallbackType> callbacks;
+};
+
+// Big enough to not fit in std::function's small buffer
+struct Payload {
+    std::array<int, 16> values{};
+};
+
+template <typename SignalType>
+void
+invokeListeners(benchmark::State &state)
+{
+    SignalType signal;
+    int sum = 0;
+    Payload payload;
+
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        signal.connect([&sum, payload](int v) {
+            sum += v + payload.values[0];
+            return false;
+        });
+    }
+
+    for (auto _ : state) {
+        signal.invoke(1);
+    }
+
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void
+BM_LegacySelfDisconnectingSignal_Invoke(benchmark::State &state)
+{
+    invokeListeners<LegacySelfDisconnectingSignal<int>>(state);
+}
+
+void
+BM_SelfDisconnectingSignal_Invoke(benchmark::State &state)
+{
+    invokeListeners<SelfDisconnectingSignal<int>>(state);
+}
+
+}  // namespace
+
+BENCHMARK(BM_LegacySelfDisconnectingSignal_Invoke)->Range(1, 1024);
+BENCHMARK(BM_SelfDisconnectingSignal_Invoke)->Range(1, 1024);
@@ -0,0 +1,50 @@
+#include <pajlada/signals/sharded-signal.hpp>
+#include <pajlada/signals/signal.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace pajlada::Signals;
+
+namespace {
+
+template <typename SignalType>
+void
+connectDisconnect(benchmark::State &state, SignalType &signal)
+{
+    int64_t i = 0;
+    for (auto _ : state) {
+        auto conn = signal.connect([](int) {});
+        conn.disconnect();
+
+        // Sweep the disconnected bodies every now and then, like a real
+        // progress signal being emitted would
+        if (++i % 256 == 0) {
+            signal.invoke(1);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+void
+BM_Signal_ConnectDisconnect(benchmark::State &state)
+{
+    static Signal<int> signal;
+
+    connectDisconnect(state, signal);
+}
+
+void
+BM_ShardedSignal_ConnectDisconnect(benchmark::State &state)
+{
+    static ShardedSignal<int> signal;
+
+    connectDisconnect(state, signal);
+}
+
+}  // namespace
+
+BENCHMARK(BM_Signal_ConnectDisconnect)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_ShardedSignal_ConnectDisconnect)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
@@ -0,0 +1,99 @@
+#include <pajlada/signals/signal-combinators.hpp>
+#include <pajlada/signals/signalholder.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <mutex>
+#include <optional>
+#include <tuple>
+
+using namespace pajlada::Signals;
+
+namespace {
+
+// The mutex-guarded struct combineLatest replaces
+class LockedLatest
+{
+public:
+    LockedLatest(Signal<int> &a, Signal<int> &b)
+    {
+        this->holder.managedConnect(a, [this](int value) {
+            this->update(value, this->latestA);
+        });
+        this->holder.managedConnect(b, [this](int value) {
+            this->update(value, this->latestB);
+        });
+    }
+
+    Signal<const std::tuple<int, int> &> signal;
+
+private:
+    std::mutex mutex;
+    std::optional<int> latestA;
+    std::optional<int> latestB;
+    SignalHolder holder;
+
+    void
+    update(int value, std::optional<int> &latest)
+    {
+        std::tuple<int, int> values;
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+
+            latest = value;
+            if (!this->latestA || !this->latestB) {
+                return;
+            }
+            values = {*this->latestA, *this->latestB};
+        }
+
+        this->signal.invoke(values);
+    }
+};
+
+void
+BM_LockedLatest_Invoke(benchmark::State &state)
+{
+    Signal<int> a;
+    Signal<int> b;
+    LockedLatest latest(a, b);
+    int64_t sum = 0;
+
+    auto conn = latest.signal.connect([&sum](const std::tuple<int, int> &v) {
+        sum += std::get<0>(v) + std::get<1>(v);
+    });
+
+    b.invoke(1);
+    for (auto _ : state) {
+        a.invoke(1);
+    }
+
+    benchmark::DoNotOptimize(sum);
+}
+
+void
+BM_CombineLatest_Invoke(benchmark::State &state)
+{
+    Signal<int> a;
+    Signal<int> b;
+    auto latest = combineLatest(a, b);
+    int64_t sum = 0;
+
+    auto conn =
+        latest.getSignal().connect([&sum](const std::tuple<int, int> &v) {
+            sum += std::get<0>(v) + std::get<1>(v);
+        });
+
+    b.invoke(1);
+    for (auto _ : state) {
+        a.invoke(1);
+    }
+
+    benchmark::DoNotOptimize(sum);
+}
+
+}  // namespace
+
+BENCHMARK(BM_LockedLatest_Invoke);
+BENCHMARK(BM_CombineLatest_Invoke);
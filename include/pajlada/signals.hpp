@@ -1,6 +1,22 @@
 #pragma once
 
+#include <pajlada/signals/broadcast-signal.hpp>
+#include <pajlada/signals/combiners.hpp>
+#include <pajlada/signals/compact-signal.hpp>
+#include <pajlada/signals/concurrent-bolt-signal.hpp>
 #include <pajlada/signals/connection.hpp>
+#include <pajlada/signals/dense-signal.hpp>
+#include <pajlada/signals/event-bus.hpp>
+#include <pajlada/signals/invoke-completion.hpp>
+#include <pajlada/signals/leak-detector.hpp>
+#include <pajlada/signals/memory-usage.hpp>
+#include <pajlada/signals/move-only-function.hpp>
+#include <pajlada/signals/operators.hpp>
+#include <pajlada/signals/pollable-signal.hpp>
 #include <pajlada/signals/scoped-connection.hpp>
+#include <pajlada/signals/sharded-signal.hpp>
+#include <pajlada/signals/signal-blocker.hpp>
+#include <pajlada/signals/signal-combinators.hpp>
 #include <pajlada/signals/signal.hpp>
 #include <pajlada/signals/signalholder.hpp>
+#include <pajlada/signals/static-signal.hpp>
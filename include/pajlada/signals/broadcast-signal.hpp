@@ -0,0 +1,251 @@
+#pragma once
+
+#include "pajlada/signals/connection.hpp"
+#include "pajlada/signals/signal.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <tuple>
+#include <utility>
+
+namespace pajlada {
+namespace Signals {
+
+namespace detail {
+
+/// Recycles the blocks payloads are allocated in
+// All payloads of a signal have the same type, so the pool only ever serves
+// one block size, which is picked up from the first allocation
+class PayloadPool
+{
+public:
+    static constexpr std::size_t MAX_FREE_BLOCKS = 64;
+
+    PayloadPool() = default;
+
+    ~PayloadPool()
+    {
+        while (this->freeList != nullptr) {
+            auto *next = this->freeList->next;
+            ::operator delete(this->freeList);
+            this->freeList = next;
+        }
+    }
+
+    PayloadPool(const PayloadPool &other) = delete;
+    PayloadPool &operator=(const PayloadPool &other) = delete;
+
+    void *
+    allocate(std::size_t size)
+    {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+
+            if (this->blockSize == 0) {
+                this->blockSize = size;
+            }
+
+            if (size == this->blockSize && this->freeList != nullptr) {
+                auto *block = this->freeList;
+                this->freeList = block->next;
+                --this->freeCount;
+                return block;
+            }
+        }
+
+        return ::operator new(size < sizeof(FreeBlock) ? sizeof(FreeBlock)
+                                                       : size);
+    }
+
+    void
+    deallocate(void *pointer, std::size_t size)
+    {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+
+            if (size == this->blockSize &&
+                this->freeCount < MAX_FREE_BLOCKS) {
+                this->freeList = ::new (pointer) FreeBlock{this->freeList};
+                ++this->freeCount;
+                return;
+            }
+        }
+
+        ::operator delete(pointer);
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    std::mutex mutex;
+    std::size_t blockSize{0};
+    FreeBlock *freeList{nullptr};
+    std::size_t freeCount{0};
+};
+
+template <typename T>
+class PayloadAllocator
+{
+public:
+    using value_type = T;
+
+    explicit PayloadAllocator(std::shared_ptr<PayloadPool> _pool)
+        : pool(std::move(_pool))
+    {
+    }
+
+    template <typename U>
+    PayloadAllocator(const PayloadAllocator<U> &other)
+        : pool(other.pool)
+    {
+    }
+
+    T *
+    allocate(std::size_t n)
+    {
+        return static_cast<T *>(this->pool->allocate(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T *pointer, std::size_t n)
+    {
+        this->pool->deallocate(pointer, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool
+    operator==(const PayloadAllocator<U> &other) const
+    {
+        return this->pool == other.pool;
+    }
+
+    template <typename U>
+    bool
+    operator!=(const PayloadAllocator<U> &other) const
+    {
+        return this->pool != other.pool;
+    }
+
+private:
+    template <typename U>
+    friend class PayloadAllocator;
+
+    // Keeps the pool alive for as long as any payload allocated from it
+    std::shared_ptr<PayloadPool> pool;
+};
+
+}  // namespace detail
+
+/// Immutable, reference counted arguments of one BroadcastSignal invoke
+// Copying a payload only bumps its reference count, so listeners can queue it
+// for another thread without copying the arguments
+template <typename... Args>
+class Payload
+{
+public:
+    using ValuesType = std::tuple<Args...>;
+
+    explicit Payload(std::shared_ptr<const ValuesType> _values)
+        : values(std::move(_values))
+    {
+    }
+
+    template <std::size_t I>
+    const auto &
+    get() const
+    {
+        return std::get<I>(*this->values);
+    }
+
+    const ValuesType &
+    getValues() const
+    {
+        return *this->values;
+    }
+
+    // Number of payload handles still referring to these arguments
+    [[nodiscard]] long
+    getUseCount() const
+    {
+        return this->values.use_count();
+    }
+
+private:
+    std::shared_ptr<const ValuesType> values;
+};
+
+/// Broadcast Signals (zero-copy fan-out of large arguments)
+// invoke builds the arguments once in a pooled allocation, and every listener
+// receives a const reference to the same Payload
+template <typename... Args>
+class BroadcastSignal
+{
+public:
+    using PayloadType = Payload<Args...>;
+
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+    // site is where the signal was created, reported by
+    // LeakDetector::checkGrowth
+    BroadcastSignal(CallSite site = CallSite::current())
+        : signal(site)
+    {
+    }
+#else
+    BroadcastSignal() = default;
+#endif
+
+    BroadcastSignal(const BroadcastSignal &other) = delete;
+    BroadcastSignal &operator=(const BroadcastSignal &other) = delete;
+
+    // Listeners are called with a const PayloadType &
+    template <typename Callback>
+    [[nodiscard]] Connection
+    connect(Callback &&func, int priority = 0,
+            CallSite site = CallSite::current())
+    {
+        return this->signal.connect(std::forward<Callback>(func), priority,
+                                    site);
+    }
+
+    template <auto Method, typename T>
+    [[nodiscard]] Connection
+    connect(T *object, int priority = 0, CallSite site = CallSite::current())
+    {
+        return this->signal.template connect<Method>(object, priority, site);
+    }
+
+    // The arguments are constructed in place, e.g. from a moved buffer
+    template <typename... InvokeArgs>
+    void
+    invoke(InvokeArgs &&...args)
+    {
+        if (this->signal.getListenerCount() == 0) {
+            return;
+        }
+
+        this->signal.invoke(PayloadType(
+            std::allocate_shared<typename PayloadType::ValuesType>(
+                detail::PayloadAllocator<typename PayloadType::ValuesType>(
+                    this->pool),
+                std::forward<InvokeArgs>(args)...)));
+    }
+
+    [[nodiscard]] std::size_t
+    getListenerCount() const
+    {
+        return this->signal.getListenerCount();
+    }
+
+private:
+    std::shared_ptr<detail::PayloadPool> pool =
+        std::make_shared<detail::PayloadPool>();
+
+    Signal<const PayloadType &> signal;
+};
+
+}  // namespace Signals
+}  // namespace pajlada
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+namespace pajlada {
+namespace Signals {
+
+/// Combiners for result-collecting signals, see Signal<R(Args...)>::collect
+// add returns false once the combiner knows its result, so the remaining
+// listeners aren't called
+namespace combiners {
+
+/// Result of the first listener that returns a non-empty value
+// Works with anything that converts to bool, like std::optional or pointers
+template <typename T>
+class FirstNonEmpty
+{
+public:
+    bool
+    add(T &&value)
+    {
+        if (value) {
+            this->value = std::move(value);
+            return false;
+        }
+
+        return true;
+    }
+
+    const T &
+    result() const &
+    {
+        return this->value;
+    }
+
+    T
+    result() &&
+    {
+        return std::move(this->value);
+    }
+
+private:
+    T value{};
+};
+
+/// true if any listener returns true
+class AnyTrue
+{
+public:
+    bool
+    add(bool value)
+    {
+        this->value = value;
+        return !value;
+    }
+
+    bool
+    result() const
+    {
+        return this->value;
+    }
+
+private:
+    bool value{false};
+};
+
+/// true if every listener returns true (or there are no listeners)
+class AllTrue
+{
+public:
+    bool
+    add(bool value)
+    {
+        this->value = value;
+        return value;
+    }
+
+    bool
+    result() const
+    {
+        return this->value;
+    }
+
+private:
+    bool value{true};
+};
+
+/// Sum of every listener's result
+template <typename T>
+class Sum
+{
+public:
+    bool
+    add(T &&value)
+    {
+        this->total += std::move(value);
+        return true;
+    }
+
+    T
+    result() const
+    {
+        return this->total;
+    }
+
+private:
+    T total{};
+};
+
+/// Appends every listener's result to a caller-provided container
+// Reserve the container up front to avoid allocating while collecting
+// maxCount stops calling listeners once that many results have been collected
+template <typename Container>
+class CollectInto
+{
+public:
+    explicit CollectInto(Container &_container,
+                         std::size_t _maxCount = static_cast<std::size_t>(-1))
+        : container(_container)
+        , maxCount(_maxCount)
+    {
+    }
+
+    bool
+    add(typename Container::value_type &&value)
+    {
+        if (this->count >= this->maxCount) {
+            return false;
+        }
+
+        this->container.push_back(std::move(value));
+        return ++this->count < this->maxCount;
+    }
+
+    // Number of results collected
+    std::size_t
+    result() const
+    {
+        return this->count;
+    }
+
+private:
+    Container &container;
+    std::size_t maxCount;
+    std::size_t count{0};
+};
+
+}  // namespace combiners
+
+}  // namespace Signals
+}  // namespace pajlada
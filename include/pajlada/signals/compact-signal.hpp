@@ -0,0 +1,129 @@
+#pragma once
+
+#include "pajlada/signals/connection.hpp"
+#include "pajlada/signals/memory-usage.hpp"
+#include "pajlada/signals/signal.hpp"
+
+#include <atomic>
+#include <utility>
+
+namespace pajlada {
+namespace Signals {
+
+/// Compact Signals (pointer-sized until first connect)
+// meant for classes that declare many signals that are rarely connected to
+// connect allocates the listener storage on first use
+// invoke without listeners is a single atomic load
+// There's no room to remember where the signal was created, so the
+// LeakDetector reports the storage as created where it was first connected to
+template <typename... Args>
+class CompactSignal
+{
+public:
+    using SignalType = Signal<Args...>;
+
+    CompactSignal() = default;
+
+    ~CompactSignal()
+    {
+        delete this->impl.load(std::memory_order_acquire);
+    }
+
+    CompactSignal(const CompactSignal &other) = delete;
+    CompactSignal &operator=(const CompactSignal &other) = delete;
+    CompactSignal(CompactSignal &&other) = delete;
+    CompactSignal &operator=(CompactSignal &&other) = delete;
+
+    template <typename Callback>
+    [[nodiscard]] Connection
+    connect(Callback &&func, int priority = 0,
+            CallSite site = CallSite::current())
+    {
+        return this->getOrCreate(site)->connect(std::forward<Callback>(func),
+                                                priority, site);
+    }
+
+    template <auto Method, typename Object>
+    [[nodiscard]] Connection
+    connect(Object &&object, int priority = 0,
+            CallSite site = CallSite::current())
+    {
+        return this->getOrCreate(site)->template connect<Method>(
+            std::forward<Object>(object), priority, site);
+    }
+
+    void
+    invoke(Args... args)
+    {
+        auto *signal = this->impl.load(std::memory_order_acquire);
+        if (signal == nullptr) {
+            // Nobody has ever connected to this signal
+            return;
+        }
+
+        signal->invoke(std::forward<Args>(args)...);
+    }
+
+    // Returns true if the listener storage has been allocated
+    [[nodiscard]] bool
+    isAllocated() const
+    {
+        return this->impl.load(std::memory_order_acquire) != nullptr;
+    }
+
+    // Until the first connect this is only the pointer to the storage
+    [[nodiscard]] MemoryUsage
+    getMemoryUsage() const
+    {
+        MemoryUsage usage;
+
+        if (auto *signal = this->impl.load(std::memory_order_acquire)) {
+            usage = signal->getMemoryUsage();
+        }
+        usage.estimatedBytes += sizeof(*this);
+
+        return usage;
+    }
+
+    // Drops disconnected listeners and gives unused storage back
+    // The storage itself stays allocated once it has been
+    void
+    compact()
+    {
+        if (auto *signal = this->impl.load(std::memory_order_acquire)) {
+            signal->compact();
+        }
+    }
+
+private:
+    std::atomic<SignalType *> impl{nullptr};
+
+    SignalType *
+    getOrCreate(CallSite site)
+    {
+        auto *signal = this->impl.load(std::memory_order_acquire);
+        if (signal != nullptr) {
+            return signal;
+        }
+
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+        auto *created = new SignalType(site);
+#else
+        auto *created = new SignalType;
+#endif
+        if (this->impl.compare_exchange_strong(signal, created,
+                                               std::memory_order_acq_rel,
+                                               std::memory_order_acquire)) {
+            return created;
+        }
+
+        // Another thread connected first, use their storage instead
+        delete created;
+        return signal;
+    }
+};
+
+using NoArgCompactSignal = CompactSignal<>;
+
+}  // namespace Signals
+}  // namespace pajlada
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "pajlada/signals/move-only-function.hpp"
+
+#include <atomic>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace pajlada {
+namespace Signals {
+
+/// Concurrent Bolt Signals (1-time use, thread-safe)
+// connect is a lock-free push and can be called from any thread
+// invoke fires the connected callbacks once, further invokes are ignored
+// connecting after the signal has fired calls the callback right away
+// (on the connecting thread) with the arguments the signal was fired with
+template <class... Args>
+class ConcurrentBoltSignal
+{
+protected:
+    typedef MoveOnlyFunction<void(Args...)> CallbackType;
+
+public:
+    ConcurrentBoltSignal() = default;
+
+    ~ConcurrentBoltSignal()
+    {
+        auto *node = this->head.load(std::memory_order_acquire);
+        if (node != &firedNode) {
+            deleteList(node);
+        }
+    }
+
+    ConcurrentBoltSignal(const ConcurrentBoltSignal &other) = delete;
+    ConcurrentBoltSignal &operator=(const ConcurrentBoltSignal &other) =
+        delete;
+
+    void
+    connect(CallbackType cb)
+    {
+        auto *node = this->head.load(std::memory_order_acquire);
+        if (node == &firedNode) {
+            this->callLate(cb);
+            return;
+        }
+
+        auto *pushed = new Node{std::move(cb), node};
+        while (!this->head.compare_exchange_weak(pushed->next, pushed,
+                                                 std::memory_order_release,
+                                                 std::memory_order_acquire)) {
+            if (pushed->next == &firedNode) {
+                // We lost the race against invoke
+                this->callLate(pushed->callback);
+                delete pushed;
+                return;
+            }
+        }
+    }
+
+    void
+    invoke(Args... args)
+    {
+        if (this->invoked.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+
+        this->arguments.emplace(std::forward<Args>(args)...);
+
+        // Publishing the fired marker also publishes the stored arguments
+        auto *node = this->head.exchange(&firedNode, std::memory_order_acq_rel);
+
+        // The list was built newest-first, reverse it to fire in connect order
+        Node *ordered = nullptr;
+        while (node != nullptr) {
+            auto *next = node->next;
+            node->next = ordered;
+            ordered = node;
+            node = next;
+        }
+
+        // Frees the callbacks that didn't run if one of them throws, the
+        // destructor won't see them since the list is already marked fired
+        struct ListGuard {
+            Node *remaining;
+
+            ~ListGuard()
+            {
+                deleteList(this->remaining);
+            }
+        } guard{ordered};
+
+        while (guard.remaining != nullptr) {
+            std::apply(guard.remaining->callback,
+                       std::as_const(*this->arguments));
+
+            auto *next = guard.remaining->next;
+            delete guard.remaining;
+            guard.remaining = next;
+        }
+    }
+
+    [[nodiscard]] bool
+    isFired() const
+    {
+        return this->head.load(std::memory_order_acquire) == &firedNode;
+    }
+
+private:
+    struct Node {
+        CallbackType callback;
+        Node *next;
+    };
+
+    // Marks the list as fired, never dereferenced
+    static inline Node firedNode{};
+
+    std::atomic<Node *> head{nullptr};
+    std::atomic<bool> invoked{false};
+    std::optional<std::tuple<std::decay_t<Args>...>> arguments;
+
+    void
+    callLate(CallbackType &cb) const
+    {
+        std::apply(cb, std::as_const(*this->arguments));
+    }
+
+    static void
+    deleteList(Node *node)
+    {
+        while (node != nullptr) {
+            auto *next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+};
+
+using NoArgConcurrentBoltSignal = ConcurrentBoltSignal<>;
+
+}  // namespace Signals
+}  // namespace pajlada
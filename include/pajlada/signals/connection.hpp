@@ -1,60 +1,647 @@
 #pragma once
 
+#include "pajlada/signals/leak-detector.hpp"
+
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
 #include <utility>
+#include <vector>
+
+// Follows the compiler's setting unless defined beforehand, so building with
+// -fno-exceptions turns it off
+#if !defined(PAJLADA_SIGNALS_EXCEPTIONS)
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+#define PAJLADA_SIGNALS_EXCEPTIONS 1
+#else
+#define PAJLADA_SIGNALS_EXCEPTIONS 0
+#endif
+#endif
 
 namespace pajlada {
 namespace Signals {
 
+/// Returned by a listener to decide whether the remaining listeners are called
+// Listeners returning anything else never stop propagation
+enum class Propagation {
+    Continue,
+    Stop,
+};
+
 namespace detail {
 
+// Calls f, turning its result into a Propagation
+template <typename F, typename... CallArgs>
+Propagation
+invokeListener(F &&f, CallArgs &&...args)
+{
+    using Result = std::invoke_result_t<F, CallArgs...>;
+
+    if constexpr (std::is_same_v<Result, Propagation>) {
+        return std::invoke(std::forward<F>(f), std::forward<CallArgs>(args)...);
+    } else {
+        std::invoke(std::forward<F>(f), std::forward<CallArgs>(args)...);
+        return Propagation::Continue;
+    }
+}
+
+// Callables that can tell they will never do anything again, like a pipeline
+// whose take(n) is used up, have an isExhausted member. Their bodies
+// disconnect themselves once it returns true.
+template <typename Func, typename = void>
+struct IsExhaustible : std::false_type {
+};
+
+template <typename Func>
+struct IsExhaustible<
+    Func, std::void_t<decltype(std::declval<const Func &>().isExhausted())>>
+    : std::true_type {
+};
+
+// Whether signal.connect takes a priority and a CallSite, so wrappers like
+// managedConnect can pass their caller's location on to the LeakDetector
+template <typename Signal, typename Callback, typename = void>
+struct ConnectTakesCallSite : std::false_type {
+};
+
+template <typename Signal, typename Callback>
+struct ConnectTakesCallSite<
+    Signal, Callback,
+    std::void_t<decltype(std::declval<Signal &>().connect(
+        std::declval<Callback>(), 0, std::declval<CallSite>()))>>
+    : std::true_type {
+};
+
+template <auto Method, typename Signal, typename T, typename = void>
+struct MemberConnectTakesCallSite : std::false_type {
+};
+
+template <auto Method, typename Signal, typename T>
+struct MemberConnectTakesCallSite<
+    Method, Signal, T,
+    std::void_t<decltype(std::declval<Signal &>().template connect<Method>(
+        std::declval<T *>(), 0, std::declval<CallSite>()))>>
+    : std::true_type {
+};
+
+// Whether signal.connect takes a CallSite without a priority, like
+// ShardedSignal and DenseSignal
+template <typename Signal, typename Callback, typename = void>
+struct ConnectTakesOnlyCallSite : std::false_type {
+};
+
+template <typename Signal, typename Callback>
+struct ConnectTakesOnlyCallSite<
+    Signal, Callback,
+    std::void_t<decltype(std::declval<Signal &>().connect(
+        std::declval<Callback>(), std::declval<CallSite>()))>>
+    : std::true_type {
+};
+
+template <auto Method, typename Signal, typename T, typename = void>
+struct MemberConnectTakesOnlyCallSite : std::false_type {
+};
+
+template <auto Method, typename Signal, typename T>
+struct MemberConnectTakesOnlyCallSite<
+    Method, Signal, T,
+    std::void_t<decltype(std::declval<Signal &>().template connect<Method>(
+        std::declval<T *>(), std::declval<CallSite>()))>>
+    : std::true_type {
+};
+
+// Connects func to signal with the default priority, passing site on to
+// whichever connect takes it
+template <typename Signal, typename Callback>
+auto
+connectAt(Signal &signal, Callback &&func, [[maybe_unused]] CallSite site)
+{
+    if constexpr (ConnectTakesCallSite<Signal, Callback>::value) {
+        return signal.connect(std::forward<Callback>(func), 0, site);
+    } else if constexpr (ConnectTakesOnlyCallSite<Signal, Callback>::value) {
+        return signal.connect(std::forward<Callback>(func), site);
+    } else {
+        return signal.connect(std::forward<Callback>(func));
+    }
+}
+
+template <auto Method, typename Signal, typename T>
+auto
+connectAt(Signal &signal, T *object, [[maybe_unused]] CallSite site)
+{
+    if constexpr (MemberConnectTakesCallSite<Method, Signal, T>::value) {
+        return signal.template connect<Method>(object, 0, site);
+    } else if constexpr (MemberConnectTakesOnlyCallSite<Method, Signal,
+                                                         T>::value) {
+        return signal.template connect<Method>(object, site);
+    } else {
+        return signal.template connect<Method>(object);
+    }
+}
+
+class ConnectionGroup;
+
+/// Keeps count of how many callback bodies of a signal are connected
+// The hooks are called exactly once per transition, serialized by the mutex.
+// Bodies disconnected through their group (see SignalHolder) are counted as
+// soon as the group is invalidated, not when the signal sweeps them.
+// A hook may run while the signal is sweeping its bodies or while a group is
+// being invalidated, so it must not connect to, disconnect from or invoke the
+// signal it belongs to.
+class ListenerTracker
+{
+public:
+    ListenerTracker() = default;
+
+    // Defined after ConnectionGroup
+    ~ListenerTracker();
+
+    ListenerTracker(const ListenerTracker &other) = delete;
+    ListenerTracker &operator=(const ListenerTracker &other) = delete;
+
+    void
+    setOnFirstConnect(std::function<void()> hook)
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        this->onFirstConnect = std::move(hook);
+    }
+
+    void
+    setOnLastDisconnect(std::function<void()> hook)
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        this->onLastDisconnect = std::move(hook);
+    }
+
+    void
+    connected()
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        if (this->count.fetch_add(1, std::memory_order_relaxed) == 0 &&
+            this->onFirstConnect) {
+            this->onFirstConnect();
+        }
+    }
+
+    void
+    disconnected(std::size_t bodies = 1)
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        assert(this->count.load(std::memory_order_relaxed) >= bodies);
+
+        if (this->count.fetch_sub(bodies, std::memory_order_relaxed) ==
+                bodies &&
+            this->onLastDisconnect) {
+            this->onLastDisconnect();
+        }
+    }
+
+    [[nodiscard]] std::size_t
+    getCount() const
+    {
+        return this->count.load(std::memory_order_relaxed);
+    }
+
+    // Called by group the first time one of our bodies joins it, so we can
+    // unregister from it before we're destroyed
+    void
+    addGroup(ConnectionGroup *group);
+
+private:
+    std::mutex mutex;
+    std::atomic<std::size_t> count{0};
+
+    std::function<void()> onFirstConnect;
+    std::function<void()> onLastDisconnect;
+
+    // Groups that count some of our bodies, each holds a reference
+    std::mutex groupsMutex;
+    std::vector<ConnectionGroup *> groups;
+};
+
+/// Lets a whole group of bodies be disconnected at once
+// Each body remembers the generation it joined at, and counts as disconnected
+// as soon as the group's generation moves on.
+// The group keeps count of its connected bodies per signal, so invalidating it
+// updates the signals' listener counts in one step per signal, not per body.
+// Intrusively reference counted by its owner, by the bodies in it and by the
+// trackers of the signals it counts bodies of.
+class ConnectionGroup
+{
+public:
+    ConnectionGroup() = default;
+
+    ConnectionGroup(const ConnectionGroup &other) = delete;
+    ConnectionGroup &operator=(const ConnectionGroup &other) = delete;
+
+    void
+    addRef()
+    {
+        this->refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void
+    release()
+    {
+        if (this->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    [[nodiscard]] uint64_t
+    getGeneration() const
+    {
+        return this->generation.load(std::memory_order_acquire);
+    }
+
+    // Disconnects every body currently in the group
+    void
+    invalidate()
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        this->generation.fetch_add(1, std::memory_order_acq_rel);
+
+        for (auto &member : this->members) {
+            if (member.bodies != 0) {
+                member.tracker->disconnected(member.bodies);
+                member.bodies = 0;
+            }
+        }
+    }
+
+    // Called when a body joins the group, connected is whether it is
+    // counted by tracker right now
+    // Returns the generation the body joined at
+    uint64_t
+    join(ListenerTracker *tracker, bool connected)
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        if (tracker != nullptr && connected) {
+            ++this->getMember(tracker).bodies;
+        }
+
+        return this->generation.load(std::memory_order_relaxed);
+    }
+
+    // Passes a body's (dis)connect on to tracker, unless the group has been
+    // invalidated since the body joined, it was counted as disconnected then
+    void
+    notify(ListenerTracker *tracker, uint64_t bodyGeneration, bool connected)
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        if (this->generation.load(std::memory_order_relaxed) !=
+            bodyGeneration) {
+            return;
+        }
+
+        auto &member = this->getMember(tracker);
+        if (connected) {
+            ++member.bodies;
+            tracker->connected();
+        } else {
+            assert(member.bodies > 0);
+            --member.bodies;
+            tracker->disconnected();
+        }
+    }
+
+    // Number of bodies in the group that are still connected to a signal
+    [[nodiscard]] std::size_t
+    getConnectedCount() const
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        std::size_t count = 0;
+        for (const auto &member : this->members) {
+            count += member.bodies;
+        }
+
+        return count;
+    }
+
+    // Called by tracker when it's destroyed
+    void
+    removeTracker(ListenerTracker *tracker)
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        this->members.erase(
+            std::remove_if(this->members.begin(), this->members.end(),
+                           [tracker](const Member &member) {
+                               return member.tracker == tracker;
+                           }),
+            this->members.end());
+    }
+
+private:
+    struct Member {
+        ListenerTracker *tracker;
+
+        // Bodies of the tracker's signal that are connected and in the
+        // current generation
+        std::size_t bodies;
+    };
+
+    std::atomic<uint32_t> refCount{1};
+    std::atomic<uint64_t> generation{0};
+
+    // Serializes generation changes with the member counts
+    mutable std::mutex mutex;
+    std::vector<Member> members;
+
+    Member &
+    getMember(ListenerTracker *tracker)
+    {
+        for (auto &member : this->members) {
+            if (member.tracker == tracker) {
+                return member;
+            }
+        }
+
+        tracker->addGroup(this);
+        return this->members.emplace_back(Member{tracker, 0});
+    }
+};
+
+inline ListenerTracker::~ListenerTracker()
+{
+    // Nothing can join a group anymore, our bodies are detached by now
+    for (auto *group : this->groups) {
+        group->removeTracker(this);
+        group->release();
+    }
+}
+
+inline void
+ListenerTracker::addGroup(ConnectionGroup *group)
+{
+    group->addRef();
+
+    std::unique_lock<std::mutex> lock(this->groupsMutex);
+    this->groups.push_back(group);
+}
+
+/// Owning handle to a ConnectionGroup
+class ConnectionGroupPtr
+{
+public:
+    ConnectionGroupPtr() = default;
+
+    ~ConnectionGroupPtr()
+    {
+        this->reset();
+    }
+
+    ConnectionGroupPtr(ConnectionGroupPtr &&other) noexcept
+        : group(other.group)
+    {
+        other.group = nullptr;
+    }
+
+    ConnectionGroupPtr &
+    operator=(ConnectionGroupPtr &&other) noexcept
+    {
+        if (&other == this) {
+            return *this;
+        }
+
+        this->reset();
+        this->group = other.group;
+        other.group = nullptr;
+        return *this;
+    }
+
+    ConnectionGroupPtr(const ConnectionGroupPtr &other) = delete;
+    ConnectionGroupPtr &operator=(const ConnectionGroupPtr &other) = delete;
+
+    ConnectionGroup *
+    get() const
+    {
+        return this->group;
+    }
+
+    ConnectionGroup *
+    getOrCreate()
+    {
+        if (this->group == nullptr) {
+            this->group = new ConnectionGroup;
+        }
+
+        return this->group;
+    }
+
+    void
+    reset()
+    {
+        if (this->group != nullptr) {
+            this->group->release();
+            this->group = nullptr;
+        }
+    }
+
+private:
+    ConnectionGroup *group{nullptr};
+};
+
+/// Shared by a signal and the Connections to one of its listeners
+// Intrusively reference counted: the owner count lives in the same control
+// word as the subscriber count and the blocked/expired flags, so querying a
+// Connection is a single atomic load.
+// Owners are the signal, every Connection and every in-flight invoke.
+// Subscribers are the Connections, the body stays connected while it has any.
 class CallbackBodyBase
 {
 protected:
     explicit CallbackBodyBase() = default;
 
 public:
-    virtual ~CallbackBodyBase() = default;
+    virtual ~CallbackBodyBase()
+    {
+        if (auto *currentGroup = this->group.load(std::memory_order_acquire)) {
+            currentGroup->release();
+        }
+
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+        if (this->callSite != nullptr) {
+            this->callSite->bodyCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+#endif
+    }
+
+    CallbackBodyBase(const CallbackBodyBase &other) = delete;
+    CallbackBodyBase &operator=(const CallbackBodyBase &other) = delete;
+
+    void
+    retain()
+    {
+        this->state.fetch_add(OWNER_ONE, std::memory_order_relaxed);
+    }
+
+    void
+    release()
+    {
+        auto old = this->state.fetch_sub(OWNER_ONE, std::memory_order_acq_rel);
+
+        assert((old & OWNER_MASK) > 0);
+
+        if ((old & OWNER_MASK) == 1) {
+            delete this;
+        }
+    }
+
+    // Adds a subscriber that also owns the body, in one atomic operation
+    void
+    subscribe()
+    {
+        this->addSubscriber(OWNER_ONE);
+    }
 
     void
     addRef()
     {
-        ++this->subscriberRefCount;
+        this->addSubscriber(0);
     }
 
+
     bool
     disconnect()
     {
-        assert(this->subscriberRefCount > 0);
+        auto old =
+            this->state.fetch_sub(SUBSCRIBER_ONE, std::memory_order_acq_rel);
 
-        --this->subscriberRefCount;
+        assert((old & SUBSCRIBER_MASK) > 0);
+
+        if ((old & SUBSCRIBER_MASK) != SUBSCRIBER_ONE) {
+            return true;
+        }
+
+        if ((old & EXPIRED_BIT) == 0) {
+            this->notifyTracker(false);
+        }
+
+        this->stateChanged();
 
         return true;
     }
 
+    // Disconnects this body no matter how many subscribers still refer to it
+    // Returns false if the body had already expired
+    bool
+    expire()
+    {
+        auto old = this->state.fetch_or(EXPIRED_BIT, std::memory_order_acq_rel);
+
+        if ((old & EXPIRED_BIT) != 0) {
+            return false;
+        }
+
+        if ((old & SUBSCRIBER_MASK) > 0) {
+            this->notifyTracker(false);
+        }
+
+        this->stateChanged();
+
+        return true;
+    }
+
+    [[nodiscard]] bool
+    isExpired() const
+    {
+        return (this->state.load(std::memory_order_acquire) & EXPIRED_BIT) !=
+               0;
+    }
+
+    // Set by the owning signal so it gets told when this body (dis)connects
+    // Only called before the body is registered
+    void
+    setTracker(ListenerTracker *newTracker)
+    {
+        this->tracker.store(newTracker, std::memory_order_seq_cst);
+    }
+
+    // Stops this body from telling its tracker about (dis)connects
+    // Waits for calls running on other threads, after this returns the
+    // tracker can safely be destroyed
+    void
+    detachTracker()
+    {
+        this->tracker.store(nullptr, std::memory_order_seq_cst);
+
+        while (this->activeTrackerCalls.load(std::memory_order_seq_cst) !=
+               0) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Puts this body in group, a body can only ever join one group
+    void
+    joinGroup(ConnectionGroup *newGroup)
+    {
+        assert(this->group.load(std::memory_order_relaxed) == nullptr);
+
+        newGroup->addRef();
+
+        // Tells the group whether to count us, guarded like notifyTracker
+        this->activeTrackerCalls.fetch_add(1, std::memory_order_seq_cst);
+
+        auto current = this->state.load(std::memory_order_acquire);
+        this->groupGeneration = newGroup->join(
+            this->tracker.load(std::memory_order_seq_cst),
+            (current & SUBSCRIBER_MASK) != 0 && (current & EXPIRED_BIT) == 0);
+
+        // Publishes groupGeneration along with the group
+        this->group.store(newGroup, std::memory_order_release);
+
+        this->activeTrackerCalls.fetch_sub(1, std::memory_order_release);
+    }
+
     bool
     isConnected() const
     {
-        return this->subscriberRefCount > 0;
+        auto current = this->state.load(std::memory_order_acquire);
+
+        if ((current & SUBSCRIBER_MASK) == 0 || (current & EXPIRED_BIT) != 0) {
+            return false;
+        }
+
+        auto *currentGroup = this->group.load(std::memory_order_acquire);
+
+        return currentGroup == nullptr ||
+               currentGroup->getGeneration() == this->groupGeneration;
     }
 
     [[nodiscard]] unsigned
     getSubscriberRefCount() const
     {
-        return this->subscriberRefCount;
+        return static_cast<unsigned>(
+            (this->state.load(std::memory_order_acquire) & SUBSCRIBER_MASK) /
+            SUBSCRIBER_ONE);
     }
 
     bool
     block()
     {
-        if (this->blocked) {
+        auto old = this->state.fetch_or(BLOCKED_BIT, std::memory_order_acq_rel);
+
+        if ((old & BLOCKED_BIT) != 0) {
             return false;
         }
 
-        this->blocked = true;
+        this->stateChanged();
 
         return true;
     }
@@ -62,11 +649,14 @@ public:
     bool
     unblock()
     {
-        if (!this->blocked) {
+        auto old =
+            this->state.fetch_and(~BLOCKED_BIT, std::memory_order_acq_rel);
+
+        if ((old & BLOCKED_BIT) == 0) {
             return false;
         }
 
-        this->blocked = false;
+        this->stateChanged();
 
         return true;
     }
@@ -74,16 +664,243 @@ public:
     bool
     isBlocked() const
     {
-        return this->blocked;
+        return (this->state.load(std::memory_order_acquire) & BLOCKED_BIT) !=
+               0;
+    }
+
+    // Bodies with a higher priority are invoked first
+    // Only set by the owning signal before the body is registered
+    void
+    setPriority(int newPriority)
+    {
+        this->priority = newPriority;
+    }
+
+    [[nodiscard]] int
+    getPriority() const
+    {
+        return this->priority;
+    }
+
+    // False if the callback is noexcept, so invoking it needs no try block
+    [[nodiscard]] bool
+    mayThrow() const
+    {
+        return this->invokeMayThrow;
+    }
+
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+    // Counts this body towards entry until it is destroyed
+    // Only set by the owning signal before the body is registered
+    void
+    setCallSite(detail::CallSiteEntry *entry)
+    {
+        entry->bodyCount.fetch_add(1, std::memory_order_relaxed);
+        this->callSite = entry;
+    }
+#endif
+
+    // Size of the allocation holding this body, see makeBody
+    // Doesn't include anything the callback allocated itself
+    [[nodiscard]] virtual std::size_t getAllocationSize() const = 0;
+
+protected:
+    // Called after this body got connected, disconnected, expired, blocked or
+    // unblocked. Signals that mirror the body state elsewhere override this.
+    // May be called from any thread, and concurrently for the same body.
+    virtual void
+    stateChanged()
+    {
+    }
+
+    // Called by bodies that know their callback's type
+    void
+    setMayThrow(bool mayThrow)
+    {
+        this->invokeMayThrow = mayThrow;
     }
 
 private:
-    bool blocked{false};
+    static constexpr uint64_t OWNER_ONE = 1;
+    static constexpr uint64_t OWNER_MASK = (uint64_t(1) << 31) - 1;
+    static constexpr uint64_t SUBSCRIBER_ONE = uint64_t(1) << 31;
+    static constexpr uint64_t SUBSCRIBER_MASK = OWNER_MASK << 31;
+    static constexpr uint64_t EXPIRED_BIT = uint64_t(1) << 62;
+    static constexpr uint64_t BLOCKED_BIT = uint64_t(1) << 63;
+
+    // Owner count, subscriber count and the blocked/expired flags share one
+    // word so every state transition is a single atomic operation
+    // A new body is owned by whoever created it
+    std::atomic<uint64_t> state{OWNER_ONE};
+
+    int priority{0};
+    bool invokeMayThrow{true};
+
+    // Small enough to share the padding after invokeMayThrow
+    std::atomic<uint16_t> activeTrackerCalls{0};
+    std::atomic<ListenerTracker *> tracker{nullptr};
+
+    std::atomic<ConnectionGroup *> group{nullptr};
+    uint64_t groupGeneration{0};
+
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+    detail::CallSiteEntry *callSite{nullptr};
+#endif
+
+    void
+    addSubscriber(uint64_t owners)
+    {
+        auto old = this->state.fetch_add(SUBSCRIBER_ONE + owners,
+                                         std::memory_order_acq_rel);
+
+        if ((old & SUBSCRIBER_MASK) != 0) {
+            return;
+        }
+
+        if ((old & EXPIRED_BIT) == 0) {
+            this->notifyTracker(true);
+        }
+
+        this->stateChanged();
+    }
+
+    void
+    notifyTracker(bool connected)
+    {
+        // Pairs with detachTracker, it either waits for us or we see no tracker
+        this->activeTrackerCalls.fetch_add(1, std::memory_order_seq_cst);
+
+        if (auto *current = this->tracker.load(std::memory_order_seq_cst)) {
+            if (auto *currentGroup =
+                    this->group.load(std::memory_order_acquire)) {
+                // The group counts us while it hasn't been invalidated
+                currentGroup->notify(current, this->groupGeneration,
+                                     connected);
+            } else if (connected) {
+                current->connected();
+            } else {
+                current->disconnected();
+            }
+        }
+
+        this->activeTrackerCalls.fetch_sub(1, std::memory_order_release);
+    }
+};
+
+/// Owning pointer to a callback body, like a std::shared_ptr without the
+/// separate control block and weak count
+template <typename T>
+class BodyPtr
+{
+public:
+    BodyPtr() = default;
+
+    // Takes over the reference the caller holds on body
+    explicit BodyPtr(T *_body)
+        : body(_body)
+    {
+    }
+
+    BodyPtr(const BodyPtr &other)
+        : body(other.body)
+    {
+        if (this->body != nullptr) {
+            this->body->retain();
+        }
+    }
+
+    BodyPtr(BodyPtr &&other) noexcept
+        : body(other.body)
+    {
+        other.body = nullptr;
+    }
+
+    template <typename U,
+              typename = std::enable_if_t<std::is_convertible_v<U *, T *>>>
+    BodyPtr(BodyPtr<U> &&other) noexcept
+        : body(other.detach())
+    {
+    }
+
+    BodyPtr &
+    operator=(BodyPtr other) noexcept
+    {
+        std::swap(this->body, other.body);
+        return *this;
+    }
+
+    ~BodyPtr()
+    {
+        this->reset();
+    }
+
+    void
+    reset()
+    {
+        if (this->body != nullptr) {
+            this->body->release();
+            this->body = nullptr;
+        }
+    }
+
+    // Gives up ownership without releasing it
+    T *
+    detach()
+    {
+        auto *detached = this->body;
+        this->body = nullptr;
+        return detached;
+    }
+
+    T *
+    get() const
+    {
+        return this->body;
+    }
+
+    T *
+    operator->() const
+    {
+        return this->body;
+    }
+
+    T &
+    operator*() const
+    {
+        return *this->body;
+    }
 
-    // probably need to actually mutex-lock anything that would change our connected state
-    uint32_t subscriberRefCount{0};
+    explicit operator bool() const
+    {
+        return this->body != nullptr;
+    }
+
+private:
+    T *body{nullptr};
 };
 
+/// The type makeBody actually allocates, so bodies can report their size
+template <typename T>
+class AllocatedBody final : public T
+{
+public:
+    using T::T;
+
+    [[nodiscard]] std::size_t
+    getAllocationSize() const override
+    {
+        return sizeof(AllocatedBody);
+    }
+};
+
+template <typename T, typename... ConstructorArgs>
+BodyPtr<T>
+makeBody(ConstructorArgs &&...args)
+{
+    return BodyPtr<T>(
+        new AllocatedBody<T>(std::forward<ConstructorArgs>(args)...));
+}
+
 template <typename... Args>
 class CallbackBody : public CallbackBodyBase
 {
@@ -94,11 +911,172 @@ public:
 
     using FunctionSignature = std::function<void(Args...)>;
 
-    FunctionSignature func;
+    virtual Propagation invoke(Args... args) = 0;
+};
+
+/// Stores the connected callable as-is, so move-only callables work and
+/// no std::function is involved
+template <typename Func, typename... Args>
+class FunctionCallbackBody : public CallbackBody<Args...>
+{
+public:
+    template <typename F>
+    explicit FunctionCallbackBody(F &&_func)
+        : func(std::forward<F>(_func))
+    {
+        this->setMayThrow(!std::is_nothrow_invocable_v<Func &, Args...>);
+    }
+
+    Propagation
+    invoke(Args... args) override
+    {
+        auto result = invokeListener(this->func, std::forward<Args>(args)...);
+
+        if constexpr (IsExhaustible<Func>::value) {
+            if (this->func.isExhausted()) {
+                this->expire();
+            }
+        }
+
+        return result;
+    }
+
+    Func func;
+};
+
+template <typename... Args>
+class SelfDisconnectingCallbackBody : public CallbackBodyBase
+{
+public:
+    // Returns true if the callback wants to be disconnected
+    virtual bool invoke(Args... args) = 0;
+};
+
+template <typename Func, typename... Args>
+class FunctionSelfDisconnectingCallbackBody
+    : public SelfDisconnectingCallbackBody<Args...>
+{
+public:
+    template <typename F>
+    explicit FunctionSelfDisconnectingCallbackBody(F &&_func)
+        : func(std::forward<F>(_func))
+    {
+    }
+
+    bool
+    invoke(Args... args) override
+    {
+        return this->func(std::forward<Args>(args)...);
+    }
+
+    Func func;
+};
+
+/// Callback body whose result is handed to a combiner, see Signal<R(Args...)>
+template <typename R, typename... Args>
+class ResultCallbackBody : public CallbackBodyBase
+{
+public:
+    virtual R invoke(Args... args) = 0;
+};
+
+template <typename Func, typename R, typename... Args>
+class FunctionResultCallbackBody : public ResultCallbackBody<R, Args...>
+{
+public:
+    template <typename F>
+    explicit FunctionResultCallbackBody(F &&_func)
+        : func(std::forward<F>(_func))
+    {
+    }
+
+    R
+    invoke(Args... args) override
+    {
+        return std::invoke(this->func, std::forward<Args>(args)...);
+    }
+
+    Func func;
+};
+
+template <auto Method, typename T, typename R, typename... Args>
+class MemberResultCallbackBody : public ResultCallbackBody<R, Args...>
+{
+public:
+    explicit MemberResultCallbackBody(T *_object)
+        : object(_object)
+    {
+    }
+
+    R
+    invoke(Args... args) override
+    {
+        return std::invoke(Method, this->object, std::forward<Args>(args)...);
+    }
+
+private:
+    T *object;
+};
+
+/// Calls a member function known at compile time on a raw object pointer
+// The caller is responsible for disconnecting before the object dies,
+// i.e. by storing the Connection in a ScopedConnection or SignalHolder member
+template <auto Method, typename T, typename... Args>
+class MemberCallbackBody : public CallbackBody<Args...>
+{
+public:
+    explicit MemberCallbackBody(T *_object)
+        : object(_object)
+    {
+        this->setMayThrow(
+            !std::is_nothrow_invocable_v<decltype(Method), T *, Args...>);
+    }
+
+    Propagation
+    invoke(Args... args) override
+    {
+        return invokeListener(Method, this->object,
+                              std::forward<Args>(args)...);
+    }
+
+private:
+    T *object;
+};
+
+/// Calls a member function known at compile time on a weakly tracked object
+// Once the object has been destroyed, the callback is skipped
+template <auto Method, typename T, typename... Args>
+class TrackedMemberCallbackBody : public CallbackBody<Args...>
+{
+public:
+    explicit TrackedMemberCallbackBody(std::weak_ptr<T> _object)
+        : object(std::move(_object))
+    {
+        this->setMayThrow(
+            !std::is_nothrow_invocable_v<decltype(Method), T *, Args...>);
+    }
+
+    Propagation
+    invoke(Args... args) override
+    {
+        if (auto strongObject = this->object.lock()) {
+            return invokeListener(Method, strongObject.get(),
+                                  std::forward<Args>(args)...);
+        }
+
+        return Propagation::Continue;
+    }
+
+private:
+    std::weak_ptr<T> object;
 };
 
 }  // namespace detail
 
+/// Handle to a listener connected to a signal
+// Holds a reference on the listener's body, so querying it never touches the
+// signal. Once the signal is destroyed the body expires and the Connection
+// behaves like an empty one.
 class Connection
 {
 public:
@@ -106,17 +1084,26 @@ public:
 
     Connection(const Connection &other)
     {
-        this->connect(other.weakCallbackBody);
+        this->connect(other.callbackBody);
     }
 
-    Connection(const std::weak_ptr<detail::CallbackBodyBase> &connectionBody)
+    explicit Connection(detail::CallbackBodyBase *connectionBody)
     {
         this->connect(connectionBody);
     }
 
     Connection(Connection &&other) noexcept
-        : weakCallbackBody(std::move(other.weakCallbackBody))
+        : callbackBody(other.callbackBody)
     {
+        other.callbackBody = nullptr;
+    }
+
+    ~Connection()
+    {
+        // Only lets go of the body, the listener stays connected
+        if (this->callbackBody != nullptr) {
+            this->callbackBody->release();
+        }
     }
 
     Connection &
@@ -127,7 +1114,8 @@ public:
         }
 
         this->disconnect();
-        this->weakCallbackBody = std::move(other.weakCallbackBody);
+        this->callbackBody = other.callbackBody;
+        other.callbackBody = nullptr;
         return *this;
     }
 
@@ -139,37 +1127,39 @@ public:
         }
 
         // Connect to other's body
-        this->connect(other.weakCallbackBody);
+        this->connect(other.callbackBody);
 
         return *this;
     }
 
-    void
-    connect(std::weak_ptr<detail::CallbackBodyBase> weakBody)
+    bool
+    disconnect()
     {
-        // Disconnect from a previous body
-        this->disconnect();
+        auto *body = this->callbackBody;
+        if (body == nullptr) {
+            return false;
+        }
 
-        auto body = weakBody.lock();
+        this->callbackBody = nullptr;
 
-        if (body) {
-            this->weakCallbackBody = body;
+        bool expired = body->isExpired();
+        body->disconnect();
+        body->release();
 
-            body->addRef();
-        }
+        return !expired;
     }
 
+    // Puts the connected body in group, so it is disconnected once the group
+    // is invalidated (see SignalHolder)
     bool
-    disconnect()
+    joinGroup(detail::ConnectionGroup *group)
     {
-        auto connectionBody(this->weakCallbackBody.lock());
-        if (!connectionBody) {
+        auto *body = this->getBody();
+        if (body == nullptr) {
             return false;
         }
 
-        connectionBody->disconnect();
-
-        this->weakCallbackBody.reset();
+        body->joinGroup(group);
 
         return true;
     }
@@ -177,12 +1167,12 @@ public:
     [[nodiscard]] bool
     isConnected() const
     {
-        auto connectionBody(this->weakCallbackBody.lock());
-        if (!connectionBody) {
+        auto *body = this->getBody();
+        if (body == nullptr) {
             return false;
         }
 
-        return connectionBody->isConnected();
+        return body->isConnected();
     }
 
     struct SubscriberRefCountResponse {
@@ -193,49 +1183,73 @@ public:
     [[nodiscard]] SubscriberRefCountResponse
     getSubscriberRefCount() const
     {
-        auto connectionBody(this->weakCallbackBody.lock());
-        if (!connectionBody) {
+        auto *body = this->getBody();
+        if (body == nullptr) {
             return {0, false};
         }
 
-        return {connectionBody->getSubscriberRefCount(), true};
+        return {body->getSubscriberRefCount(), true};
     }
 
     bool
     block()
     {
-        auto connectionBody(this->weakCallbackBody.lock());
-        if (!connectionBody) {
+        auto *body = this->getBody();
+        if (body == nullptr) {
             return false;
         }
 
-        return connectionBody->block();
+        return body->block();
     }
 
     bool
     unblock()
     {
-        auto connectionBody(this->weakCallbackBody.lock());
-        if (!connectionBody) {
+        auto *body = this->getBody();
+        if (body == nullptr) {
             return false;
         }
 
-        return connectionBody->unblock();
+        return body->unblock();
     }
 
     bool
     isBlocked() const
     {
-        auto connectionBody(this->weakCallbackBody.lock());
-        if (!connectionBody) {
+        auto *body = this->getBody();
+        if (body == nullptr) {
             return false;
         }
 
-        return connectionBody->isBlocked();
+        return body->isBlocked();
     }
 
 private:
-    std::weak_ptr<detail::CallbackBodyBase> weakCallbackBody;
+    detail::CallbackBodyBase *callbackBody{nullptr};
+
+    // Returns nullptr if there is no body, or if it has expired
+    detail::CallbackBodyBase *
+    getBody() const
+    {
+        if (this->callbackBody == nullptr || this->callbackBody->isExpired()) {
+            return nullptr;
+        }
+
+        return this->callbackBody;
+    }
+
+    // Subscribes to body, used by the constructors and copy assignment
+    void
+    connect(detail::CallbackBodyBase *body)
+    {
+        // Disconnect from a previous body
+        this->disconnect();
+
+        if (body != nullptr) {
+            body->subscribe();
+            this->callbackBody = body;
+        }
+    }
 };
 
 }  // namespace Signals
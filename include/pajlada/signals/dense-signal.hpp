@@ -0,0 +1,667 @@
+#pragma once
+
+#include "pajlada/signals/connection.hpp"
+#include "pajlada/signals/memory-usage.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace pajlada {
+namespace Signals {
+
+namespace detail {
+
+// Index of the lowest set bit, bits must not be 0
+inline unsigned
+lowestSetBit(uint64_t bits)
+{
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward64(&index, bits);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#endif
+}
+
+/// Fixed block of listener slots with their state mirrored in bitmaps
+// A chunk never moves once allocated, so bodies can point straight at their
+// words in the bitmaps
+template <typename BodyType>
+struct DenseChunk {
+    static constexpr std::size_t WORD_COUNT = 4;
+    static constexpr std::size_t SLOT_COUNT = WORD_COUNT * 64;
+
+    // Slots whose body is connected and not blocked
+    std::array<std::atomic<uint64_t>, WORD_COUNT> live{};
+
+    // Slots whose body got disconnected and is waiting to be swept
+    std::array<std::atomic<uint64_t>, WORD_COUNT> dead{};
+
+    std::array<BodyPtr<BodyType>, SLOT_COUNT> bodies;
+
+    // When each slot's body was placed, see DenseSignal::generation
+    // Checked before looking at the body, so an invoke never touches a slot
+    // that got reused after it started
+    std::array<std::atomic<uint64_t>, SLOT_COUNT> generations{};
+
+    // Shared by all chunks of a signal, counts the dead bits that are set
+    std::atomic<std::size_t> *deadCount{nullptr};
+
+    // Chunks are linked in slot order, so invokes can walk them while new
+    // chunks are being added
+    std::atomic<DenseChunk *> next{nullptr};
+};
+
+/// Callback body that keeps its slot's bits up to date
+template <typename... Args>
+class DenseBody : public CallbackBody<Args...>
+{
+public:
+    using ChunkType = DenseChunk<DenseBody>;
+
+    // Only called by the owning signal, under its mutex
+    void
+    attach(ChunkType *_chunk, std::size_t slot)
+    {
+        this->word = slot / 64;
+        this->mask = uint64_t(1) << (slot % 64);
+        this->chunk.store(_chunk, std::memory_order_seq_cst);
+    }
+
+    // Stops this body from touching its slot's bits
+    // Waits for state changes running on other threads, after this returns
+    // the slot can safely be given to another body
+    void
+    detach()
+    {
+        this->chunk.store(nullptr, std::memory_order_seq_cst);
+
+        while (this->activeStateChanges.load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Brings the bits in line with the current state
+    void
+    refresh()
+    {
+        this->stateChanged();
+    }
+
+    [[nodiscard]] uint64_t
+    getMask() const
+    {
+        return this->mask;
+    }
+
+protected:
+    void
+    stateChanged() override
+    {
+        // Pairs with detach, either it waits for us or we see no chunk
+        this->activeStateChanges.fetch_add(1, std::memory_order_seq_cst);
+
+        if (auto *currentChunk = this->chunk.load(std::memory_order_seq_cst)) {
+            this->updateBits(*currentChunk);
+        }
+
+        this->activeStateChanges.fetch_sub(1, std::memory_order_release);
+    }
+
+private:
+    std::atomic<ChunkType *> chunk{nullptr};
+    std::atomic<uint32_t> activeStateChanges{0};
+    std::size_t word{0};
+    uint64_t mask{0};
+
+    void
+    updateBits(ChunkType &currentChunk)
+    {
+        auto &live = currentChunk.live[this->word];
+        auto &dead = currentChunk.dead[this->word];
+
+        // Concurrent changes may write their bits out of order, so repeat
+        // until the bits match the state read after writing them
+        bool isLive = false;
+        bool isDead = false;
+        do {
+            isLive = this->isConnected() && !this->isBlocked();
+            isDead = !this->isConnected();
+
+            if (isLive) {
+                live.fetch_or(this->mask, std::memory_order_acq_rel);
+            } else {
+                live.fetch_and(~this->mask, std::memory_order_acq_rel);
+            }
+
+            if (isDead) {
+                auto old = dead.fetch_or(this->mask, std::memory_order_acq_rel);
+                if ((old & this->mask) == 0) {
+                    currentChunk.deadCount->fetch_add(
+                        1, std::memory_order_acq_rel);
+                }
+            }
+        } while (isLive != (this->isConnected() && !this->isBlocked()) ||
+                 isDead != !this->isConnected());
+    }
+};
+
+template <typename Func, typename... Args>
+class DenseFunctionBody : public DenseBody<Args...>
+{
+public:
+    template <typename F>
+    explicit DenseFunctionBody(F &&_func)
+        : func(std::forward<F>(_func))
+    {
+    }
+
+    Propagation
+    invoke(Args... args) override
+    {
+        auto result = invokeListener(this->func, std::forward<Args>(args)...);
+
+        if constexpr (IsExhaustible<Func>::value) {
+            if (this->func.isExhausted()) {
+                this->expire();
+            }
+        }
+
+        return result;
+    }
+
+    Func func;
+};
+
+template <auto Method, typename T, typename... Args>
+class DenseMemberBody : public DenseBody<Args...>
+{
+public:
+    explicit DenseMemberBody(T *_object)
+        : object(_object)
+    {
+    }
+
+    Propagation
+    invoke(Args... args) override
+    {
+        return invokeListener(Method, this->object,
+                              std::forward<Args>(args)...);
+    }
+
+private:
+    T *object;
+};
+
+}  // namespace detail
+
+/// Dense Signals (for signals with a large number of listeners)
+// Whether a listener is connected and unblocked is mirrored in bitmaps next to
+// the listener slots. invoke scans those a word at a time and only touches
+// the listeners it actually calls, so blocked listeners cost next to nothing.
+// Listeners are called in slot order. Slots of disconnected listeners are
+// reused, so unlike Signal the call order is not the connection order, and
+// there are no priorities.
+// A listener returning Propagation::Stop skips all remaining listeners.
+// Listeners connected while an invoke is running are skipped by that invoke,
+// and the slots of disconnected listeners are only reused once the invokes
+// that might still be looking at them are done.
+template <typename... Args>
+class DenseSignal
+{
+    using BodyType = detail::DenseBody<Args...>;
+    using ChunkType = typename BodyType::ChunkType;
+
+public:
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+    // site is where the signal was created, reported by
+    // LeakDetector::checkGrowth
+    DenseSignal(CallSite site = CallSite::current())
+    {
+        LeakDetector::instance().addSignal(this, site, &countStored);
+    }
+#else
+    DenseSignal() = default;
+#endif
+
+    ~DenseSignal()
+    {
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+        // Before taking our own lock, the detector locks us while it holds its
+        LeakDetector::instance().removeSignal(this);
+#endif
+
+        // Bodies may outlive us if a Connection is holding them right now
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        for (auto &chunk : this->chunks) {
+            for (auto &body : chunk->bodies) {
+                if (body) {
+                    this->release(*body);
+                }
+            }
+        }
+    }
+
+    DenseSignal(const DenseSignal &other) = delete;
+    DenseSignal &operator=(const DenseSignal &other) = delete;
+
+    template <typename Callback>
+    [[nodiscard]] Connection
+    connect(Callback &&func, CallSite site = CallSite::current())
+    {
+        using Func = std::decay_t<Callback>;
+
+        static_assert(std::is_invocable_v<Func &, Args...>,
+                      "Callback must be callable with the signal's arguments");
+
+        return this->add(
+            detail::makeBody<detail::DenseFunctionBody<Func, Args...>>(
+                std::forward<Callback>(func)),
+            site);
+    }
+
+    // Usage: signal.connect<&Foo::onBar>(foo)
+    template <auto Method, typename T>
+    [[nodiscard]] Connection
+    connect(T *object, CallSite site = CallSite::current())
+    {
+        static_assert(std::is_member_function_pointer_v<decltype(Method)>,
+                      "Method must be a member function pointer");
+        static_assert(std::is_invocable_v<decltype(Method), T *, Args...>,
+                      "Method must be callable with the signal's arguments");
+
+        return this->add(
+            detail::makeBody<detail::DenseMemberBody<Method, T, Args...>>(
+                object),
+            site);
+    }
+
+    void
+    invoke(Args... args)
+    {
+        if (this->tracker.getCount() == 0) {
+            return;
+        }
+
+        ChunkType *chunk = nullptr;
+        std::size_t chunkCount = 0;
+        uint64_t startGeneration = 0;
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+
+            if (!this->chunks.empty()) {
+                chunk = this->chunks.front().get();
+            }
+            chunkCount = this->chunks.size();
+            startGeneration = this->generation;
+            this->runningInvokes.push_back(startGeneration);
+        }
+
+        // Leaves the iteration even if a listener throws
+        struct IterationGuard {
+            DenseSignal *signal;
+            uint64_t startGeneration;
+
+            ~IterationGuard()
+            {
+                this->signal->finishIteration(this->startGeneration);
+            }
+        } guard{this, startGeneration};
+
+        // A slot whose live bit we see holds its body until we're done
+        for (std::size_t c = 0; c < chunkCount;
+             ++c, chunk = chunk->next.load(std::memory_order_acquire)) {
+            for (std::size_t w = 0; w < ChunkType::WORD_COUNT; ++w) {
+                auto bits = chunk->live[w].load(std::memory_order_acquire);
+
+                while (bits != 0) {
+                    auto slot = w * 64 + detail::lowestSetBit(bits);
+                    bits &= bits - 1;
+
+                    if (chunk->generations[slot].load(
+                            std::memory_order_acquire) > startGeneration) {
+                        // Connected after this invoke started
+                        continue;
+                    }
+
+                    auto &body = *chunk->bodies[slot];
+
+                    if (!body.isConnected()) {
+                        // Disconnected through its group, which doesn't
+                        // update the bits. This marks it dead.
+                        body.expire();
+                        continue;
+                    }
+
+                    if (body.isBlocked()) {
+                        continue;
+                    }
+
+                    if (body.invoke(args...) == Propagation::Stop) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+    // Number of connected listeners, including blocked ones
+    [[nodiscard]] std::size_t
+    getListenerCount() const
+    {
+        return this->tracker.getCount();
+    }
+
+    // Number of listener slots, used or not
+    [[nodiscard]] std::size_t
+    getSlotCount() const
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        return this->chunks.size() * ChunkType::SLOT_COUNT;
+    }
+
+    // Bodies still waiting for a running invoke to be done with their slot
+    // count as dead, capacity is the number of slots
+    [[nodiscard]] MemoryUsage
+    getMemoryUsage() const
+    {
+        MemoryUsage usage;
+
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        for (const auto &chunk : this->chunks) {
+            for (const auto &body : chunk->bodies) {
+                if (!body) {
+                    continue;
+                }
+
+                if (body->isConnected()) {
+                    ++usage.liveListeners;
+                } else {
+                    ++usage.deadListeners;
+                }
+                usage.estimatedBytes += body->getAllocationSize();
+            }
+        }
+
+        usage.capacity = this->chunks.size() * ChunkType::SLOT_COUNT;
+        usage.estimatedBytes +=
+            sizeof(*this) + this->chunks.size() * sizeof(ChunkType) +
+            this->chunks.capacity() * sizeof(std::unique_ptr<ChunkType>) +
+            this->freeSlots.capacity() * sizeof(std::size_t) +
+            this->runningInvokes.capacity() * sizeof(uint64_t) +
+            this->retiredSlots.capacity() * sizeof(RetiredSlot);
+
+        return usage;
+    }
+
+    // Frees the slots of disconnected listeners and gives unused storage
+    // back, i.e. after disconnecting a large number of listeners
+    // Chunks at the end that have no listeners left are only freed while no
+    // invoke is running, since invokes walk them without holding the lock
+    void
+    compact()
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        for (const auto &chunk : this->chunks) {
+            for (const auto &body : chunk->bodies) {
+                if (body && !body->isConnected()) {
+                    // Disconnected through its group, which doesn't update
+                    // the bits. This marks it dead.
+                    body->expire();
+                }
+            }
+        }
+
+        this->sweepLocked();
+        this->freeRetiredLocked();
+
+        if (this->runningInvokes.empty()) {
+            while (!this->chunks.empty() && isUnused(*this->chunks.back())) {
+                this->chunks.pop_back();
+            }
+
+            if (!this->chunks.empty()) {
+                this->chunks.back()->next.store(nullptr,
+                                                std::memory_order_release);
+            }
+
+            auto slotCount = this->chunks.size() * ChunkType::SLOT_COUNT;
+            this->usedSlots = std::min(this->usedSlots, slotCount);
+            this->freeSlots.erase(
+                std::remove_if(this->freeSlots.begin(), this->freeSlots.end(),
+                               [slotCount](std::size_t slot) {
+                                   return slot >= slotCount;
+                               }),
+                this->freeSlots.end());
+        }
+
+        detail::shrinkToFit(this->chunks);
+        detail::shrinkToFit(this->freeSlots);
+        detail::shrinkToFit(this->retiredSlots);
+    }
+
+private:
+    detail::ListenerTracker tracker;
+
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<ChunkType>> chunks;
+    std::vector<std::size_t> freeSlots;
+    std::size_t usedSlots{0};
+
+    std::atomic<std::size_t> deadCount{0};
+
+    // Bumped whenever a body is placed or a slot is retired. Bodies are
+    // stamped with it, and an invoke skips bodies stamped after it started.
+    uint64_t generation{0};
+
+    // Generation each running invoke started at
+    std::vector<uint64_t> runningInvokes;
+
+    // Slots of swept bodies, kept until no invoke that started while their
+    // body was placed is running anymore
+    struct RetiredSlot {
+        std::size_t slot;
+        uint64_t placedAt;
+        uint64_t retiredAt;
+    };
+    std::vector<RetiredSlot> retiredSlots;
+
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+    // Bodies we're holding on to, disconnected or not, for LeakDetector
+    static std::size_t
+    countStored(const void *self)
+    {
+        auto usage = static_cast<const DenseSignal *>(self)->getMemoryUsage();
+
+        return usage.liveListeners + usage.deadListeners;
+    }
+#endif
+
+    Connection
+    add(detail::BodyPtr<BodyType> &&body, [[maybe_unused]] CallSite site)
+    {
+        body->setTracker(&this->tracker);
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+        body->setCallSite(LeakDetector::instance().acquireCallSite(site));
+#endif
+
+        // Connected before it is published, so it can't be swept right away
+        Connection connection(body.get());
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+
+            this->placeLocked(std::move(body));
+        }
+
+        return connection;
+    }
+
+    void
+    placeLocked(detail::BodyPtr<BodyType> &&body)
+    {
+        if (this->freeSlots.empty() &&
+            this->usedSlots == this->chunks.size() * ChunkType::SLOT_COUNT) {
+            // Reuse the slots of dead bodies before growing
+            this->sweepLocked();
+            this->freeRetiredLocked();
+        }
+
+        std::size_t slot = 0;
+        if (!this->freeSlots.empty()) {
+            slot = this->freeSlots.back();
+            this->freeSlots.pop_back();
+        } else {
+            if (this->usedSlots == this->chunks.size() * ChunkType::SLOT_COUNT) {
+                auto *last =
+                    this->chunks.empty() ? nullptr : this->chunks.back().get();
+
+                this->chunks.emplace_back(std::make_unique<ChunkType>());
+                this->chunks.back()->deadCount = &this->deadCount;
+
+                if (last != nullptr) {
+                    last->next.store(this->chunks.back().get(),
+                                     std::memory_order_release);
+                }
+            }
+            slot = this->usedSlots++;
+        }
+
+        auto *chunk = this->chunks[slot / ChunkType::SLOT_COUNT].get();
+        auto index = slot % ChunkType::SLOT_COUNT;
+
+        auto *placed = body.get();
+
+        chunk->generations[index].store(++this->generation,
+                                        std::memory_order_release);
+        placed->attach(chunk, index);
+
+        // Stored before its live bit is set, invokes only look at slots whose
+        // bit they see
+        chunk->bodies[index] = std::move(body);
+        placed->refresh();
+    }
+
+    void
+    finishIteration(uint64_t startGeneration)
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        auto running = std::find(this->runningInvokes.begin(),
+                                 this->runningInvokes.end(), startGeneration);
+        *running = this->runningInvokes.back();
+        this->runningInvokes.pop_back();
+
+        if (this->deadCount.load(std::memory_order_acquire) != 0) {
+            this->sweepLocked();
+        }
+
+        this->freeRetiredLocked();
+    }
+
+    // Gives back the retired slots no running invoke may look at
+    // Invokes that started before the body was placed skip it, invokes that
+    // started after it was retired don't see its live bit
+    void
+    freeRetiredLocked()
+    {
+        auto freed = std::remove_if(
+            this->retiredSlots.begin(), this->retiredSlots.end(),
+            [this](const RetiredSlot &retired) {
+                for (auto startGeneration : this->runningInvokes) {
+                    if (startGeneration >= retired.placedAt &&
+                        startGeneration < retired.retiredAt) {
+                        return false;
+                    }
+                }
+
+                auto &chunk =
+                    *this->chunks[retired.slot / ChunkType::SLOT_COUNT];
+                chunk.bodies[retired.slot % ChunkType::SLOT_COUNT] = {};
+
+                this->freeSlots.push_back(retired.slot);
+                return true;
+            });
+        this->retiredSlots.erase(freed, this->retiredSlots.end());
+    }
+
+    // Retires the slots of dead bodies, see freeRetiredLocked
+    void
+    sweepLocked()
+    {
+        for (std::size_t c = 0; c < this->chunks.size(); ++c) {
+            auto &chunk = *this->chunks[c];
+
+            for (std::size_t w = 0; w < ChunkType::WORD_COUNT; ++w) {
+                auto bits = chunk.dead[w].load(std::memory_order_acquire);
+
+                while (bits != 0) {
+                    auto index = w * 64 + detail::lowestSetBit(bits);
+                    bits &= bits - 1;
+
+                    auto &body = *chunk.bodies[index];
+                    auto mask = body.getMask();
+
+                    body.expire();
+                    this->release(body);
+
+                    // No state change can touch the bits anymore
+                    chunk.live[w].fetch_and(~mask, std::memory_order_acq_rel);
+                    chunk.dead[w].fetch_and(~mask, std::memory_order_acq_rel);
+                    this->deadCount.fetch_sub(1, std::memory_order_acq_rel);
+
+                    // Running invokes may still be looking at the body
+                    this->retiredSlots.push_back(
+                        {c * ChunkType::SLOT_COUNT + index,
+                         chunk.generations[index].load(
+                             std::memory_order_relaxed),
+                         ++this->generation});
+                }
+            }
+        }
+    }
+
+    static bool
+    isUnused(const ChunkType &chunk)
+    {
+        for (const auto &body : chunk.bodies) {
+            if (body) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static void
+    release(BodyType &body)
+    {
+        body.detach();
+        body.detachTracker();
+        body.expire();
+    }
+};
+
+using NoArgDenseSignal = DenseSignal<>;
+
+}  // namespace Signals
+}  // namespace pajlada
@@ -0,0 +1,242 @@
+#pragma once
+
+#include "pajlada/signals/connection.hpp"
+#include "pajlada/signals/signal.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <type_traits>
+#include <utility>
+
+namespace pajlada {
+namespace Signals {
+
+namespace detail {
+
+// See EventBus::MAX_EVENT_TYPES
+inline constexpr std::size_t MAX_EVENT_TYPES = 4096;
+
+inline std::size_t
+nextEventTypeId()
+{
+    static std::atomic<std::size_t> nextId{0};
+
+    auto id = nextId.fetch_add(1, std::memory_order_relaxed);
+    if (id >= MAX_EVENT_TYPES) {
+        // Checked here rather than on every publish, ids never change
+        // afterwards so every id handed out is a valid EventBus index
+        std::fprintf(stderr,
+                     "pajlada::Signals::EventBus: more than %zu event types "
+                     "used\n",
+                     MAX_EVENT_TYPES);
+        std::abort();
+    }
+
+    return id;
+}
+
+// Dense id of Event, shared by every EventBus
+// Assigned the first time the type is used, ids stay the same for the rest
+// of the program. Types used across a shared library boundary may get a
+// different id on each side, so don't mix buses between them.
+template <typename Event>
+std::size_t
+eventTypeId()
+{
+    static const std::size_t id = nextEventTypeId();
+
+    return id;
+}
+
+struct EventSlotBase {
+    virtual ~EventSlotBase() = default;
+};
+
+template <typename Event>
+struct EventSlot : EventSlotBase {
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+    explicit EventSlot(CallSite site)
+        : signal(site)
+    {
+    }
+#endif
+
+    Signal<const Event &> signal;
+};
+
+}  // namespace detail
+
+/// Event Bus (publish and subscribe by event type)
+// Every event type gets its own Signal<const Event &>, created the first time
+// somebody subscribes to it. The signals live in a two-level array indexed by
+// the event type's dense id, so publishing is two atomic loads followed by a
+// normal invoke, and publishing an event nobody subscribed to is free.
+class EventBus
+{
+    static constexpr std::size_t CHUNK_SIZE = 64;
+    static constexpr std::size_t CHUNK_COUNT = 64;
+
+    using Chunk = std::array<std::atomic<detail::EventSlotBase *>, CHUNK_SIZE>;
+
+public:
+    // Maximum number of event types in the whole program
+    // Using one more aborts the program, in release builds too
+    static constexpr std::size_t MAX_EVENT_TYPES = detail::MAX_EVENT_TYPES;
+    static_assert(MAX_EVENT_TYPES == CHUNK_SIZE * CHUNK_COUNT);
+
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+    // site is where the bus was created, LeakDetector::checkGrowth reports
+    // the signal of every event type as created there
+    EventBus(CallSite _site = CallSite::current())
+        : site(_site)
+    {
+    }
+#else
+    EventBus() = default;
+#endif
+
+    ~EventBus()
+    {
+        for (auto &chunkPtr : this->chunks) {
+            auto *chunk = chunkPtr.load(std::memory_order_acquire);
+            if (chunk == nullptr) {
+                continue;
+            }
+
+            for (auto &slot : *chunk) {
+                delete slot.load(std::memory_order_acquire);
+            }
+            delete chunk;
+        }
+    }
+
+    EventBus(const EventBus &other) = delete;
+    EventBus &operator=(const EventBus &other) = delete;
+    EventBus(EventBus &&other) = delete;
+    EventBus &operator=(EventBus &&other) = delete;
+
+    template <typename Event, typename Callback>
+    [[nodiscard]] Connection
+    subscribe(Callback &&func, int priority = 0,
+              CallSite site = CallSite::current())
+    {
+        return this->getSignal<Event>().connect(std::forward<Callback>(func),
+                                                priority, site);
+    }
+
+    // Usage: bus.subscribe<MyEvent, &Foo::onMyEvent>(foo)
+    template <typename Event, auto Method, typename T>
+    [[nodiscard]] Connection
+    subscribe(T *object, int priority = 0,
+              CallSite site = CallSite::current())
+    {
+        return this->getSignal<Event>().template connect<Method>(
+            object, priority, site);
+    }
+
+    template <typename Event>
+    void
+    publish(const Event &event)
+    {
+        if (auto *slot = this->findSlot<std::decay_t<Event>>()) {
+            slot->signal.invoke(event);
+        }
+    }
+
+    // The signal for Event, created if needed
+    // Lets subscriptions go through SignalHolder::managedConnect or pipe
+    template <typename Event>
+    Signal<const Event &> &
+    getSignal()
+    {
+        return this->getOrCreateSlot<Event>().signal;
+    }
+
+    template <typename Event>
+    [[nodiscard]] std::size_t
+    getListenerCount() const
+    {
+        if (auto *slot = this->findSlot<Event>()) {
+            return slot->signal.getListenerCount();
+        }
+
+        return 0;
+    }
+
+private:
+    std::array<std::atomic<Chunk *>, CHUNK_COUNT> chunks{};
+
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+    CallSite site;
+#endif
+
+    template <typename Event>
+    detail::EventSlot<Event> *
+    findSlot() const
+    {
+        auto id = detail::eventTypeId<Event>();
+
+        auto *chunk =
+            this->chunks[id / CHUNK_SIZE].load(std::memory_order_acquire);
+        if (chunk == nullptr) {
+            return nullptr;
+        }
+
+        return static_cast<detail::EventSlot<Event> *>(
+            (*chunk)[id % CHUNK_SIZE].load(std::memory_order_acquire));
+    }
+
+    template <typename Event>
+    detail::EventSlot<Event> &
+    getOrCreateSlot()
+    {
+        auto id = detail::eventTypeId<Event>();
+
+        auto &slot = (*this->getOrCreateChunk(id / CHUNK_SIZE))[id % CHUNK_SIZE];
+
+        auto *existing = slot.load(std::memory_order_acquire);
+        if (existing != nullptr) {
+            return *static_cast<detail::EventSlot<Event> *>(existing);
+        }
+
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+        auto *created = new detail::EventSlot<Event>(this->site);
+#else
+        auto *created = new detail::EventSlot<Event>;
+#endif
+        if (slot.compare_exchange_strong(existing, created,
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_acquire)) {
+            return *created;
+        }
+
+        // Another thread subscribed first, use their signal instead
+        delete created;
+        return *static_cast<detail::EventSlot<Event> *>(existing);
+    }
+
+    Chunk *
+    getOrCreateChunk(std::size_t index)
+    {
+        auto *chunk = this->chunks[index].load(std::memory_order_acquire);
+        if (chunk != nullptr) {
+            return chunk;
+        }
+
+        auto *created = new Chunk{};
+        if (this->chunks[index].compare_exchange_strong(
+                chunk, created, std::memory_order_acq_rel,
+                std::memory_order_acquire)) {
+            return created;
+        }
+
+        delete created;
+        return chunk;
+    }
+};
+
+}  // namespace Signals
+}  // namespace pajlada
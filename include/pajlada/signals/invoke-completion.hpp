@@ -0,0 +1,237 @@
+#pragma once
+
+#include "pajlada/signals/move-only-function.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace pajlada {
+namespace Signals {
+
+namespace detail {
+
+/// Countdown latch shared by an asynchronous invoke and its completion handles
+// Intrusively reference counted by the handles and by the tasks that haven't
+// run yet, so it's the only allocation an asynchronous invoke makes.
+class CompletionState
+{
+public:
+    CompletionState() = default;
+
+    virtual ~CompletionState() = default;
+
+    CompletionState(const CompletionState &other) = delete;
+    CompletionState &operator=(const CompletionState &other) = delete;
+
+    void
+    addRef()
+    {
+        this->refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void
+    release()
+    {
+        if (this->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    // Registers a task that has to finish before the invoke is complete
+    // The task owns a reference until it finishes
+    void
+    addTask()
+    {
+        this->remaining.fetch_add(1, std::memory_order_relaxed);
+        this->addRef();
+    }
+
+    // Also releases the task's reference
+    void
+    finishTask()
+    {
+        if (this->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            this->complete();
+        }
+
+        this->release();
+    }
+
+    [[nodiscard]] bool
+    isDone() const
+    {
+        return this->remaining.load(std::memory_order_acquire) == 0;
+    }
+
+    void
+    wait()
+    {
+        if (this->isDone()) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->doneCondition.wait(lock, [this] {
+            return this->done;
+        });
+    }
+
+    void
+    then(MoveOnlyFunction<void()> &&func)
+    {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+
+            if (!this->done) {
+                if (this->continuation) {
+                    // Chained, so continuations run in the order they were
+                    // added
+                    this->continuation =
+                        [first = std::move(this->continuation),
+                         second = std::move(func)]() mutable {
+                            first();
+                            second();
+                        };
+                } else {
+                    this->continuation = std::move(func);
+                }
+                return;
+            }
+        }
+
+        func();
+    }
+
+private:
+    // One reference for the first handle, one for the emitter's own task
+    std::atomic<uint32_t> refCount{2};
+
+    // Starts at 1 so the invoke can't complete while tasks are being handed
+    // out, the emitter finishes that one once it's done
+    std::atomic<uint32_t> remaining{1};
+
+    std::mutex mutex;
+    std::condition_variable doneCondition;
+    bool done{false};
+    MoveOnlyFunction<void()> continuation;
+
+    void
+    complete()
+    {
+        MoveOnlyFunction<void()> func;
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+
+            this->done = true;
+            func = std::move(this->continuation);
+        }
+
+        this->doneCondition.notify_all();
+
+        if (func) {
+            func();
+        }
+    }
+};
+
+/// Completion state that also holds the invoke's arguments, so all listeners
+/// can share a single copy of them
+template <typename... Args>
+class AsyncInvokeState : public CompletionState
+{
+public:
+    template <typename... Values>
+    explicit AsyncInvokeState(Values &&...values)
+        : arguments(std::forward<Values>(values)...)
+    {
+    }
+
+    std::tuple<std::decay_t<Args>...> arguments;
+};
+
+}  // namespace detail
+
+/// Handle to an asynchronous invoke, see Signal::invokeAsync
+// Completes once every listener the invoke was handed to has finished.
+// A default constructed handle is already complete.
+class InvokeCompletion
+{
+public:
+    InvokeCompletion() = default;
+
+    // Takes over the reference the caller holds on state
+    explicit InvokeCompletion(detail::CompletionState *_state)
+        : state(_state)
+    {
+    }
+
+    InvokeCompletion(const InvokeCompletion &other)
+        : state(other.state)
+    {
+        if (this->state != nullptr) {
+            this->state->addRef();
+        }
+    }
+
+    InvokeCompletion(InvokeCompletion &&other) noexcept
+        : state(other.state)
+    {
+        other.state = nullptr;
+    }
+
+    InvokeCompletion &
+    operator=(InvokeCompletion other) noexcept
+    {
+        std::swap(this->state, other.state);
+        return *this;
+    }
+
+    ~InvokeCompletion()
+    {
+        if (this->state != nullptr) {
+            this->state->release();
+        }
+    }
+
+    // Returns true if every listener has finished
+    [[nodiscard]] bool
+    isDone() const
+    {
+        return this->state == nullptr || this->state->isDone();
+    }
+
+    // Blocks until every listener has finished
+    void
+    wait() const
+    {
+        if (this->state != nullptr) {
+            this->state->wait();
+        }
+    }
+
+    // Calls func once every listener has finished, on the thread that ran
+    // the last listener. If that already happened, func is called right away.
+    // Several continuations run in the order they were added.
+    void
+    then(MoveOnlyFunction<void()> func) const
+    {
+        if (this->state == nullptr) {
+            func();
+            return;
+        }
+
+        this->state->then(std::move(func));
+    }
+
+private:
+    detail::CompletionState *state{nullptr};
+};
+
+}  // namespace Signals
+}  // namespace pajlada
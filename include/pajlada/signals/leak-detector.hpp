@@ -0,0 +1,264 @@
+#pragma once
+
+// Opt-in listener leak detection
+// Enabled with the PAJLADA_SIGNALS_LEAK_DETECTOR CMake option, or by defining
+// PAJLADA_SIGNALS_LEAK_DETECTOR to 1 in every translation unit. Mixing
+// translation units with and without it breaks the one definition rule.
+#if !defined(PAJLADA_SIGNALS_LEAK_DETECTOR)
+#define PAJLADA_SIGNALS_LEAK_DETECTOR 0
+#endif
+
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#endif
+
+namespace pajlada {
+namespace Signals {
+
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+
+/// Where a listener was connected or a signal was created
+// Used as a default argument, current() records the location of its caller's
+// caller, i.e. the line calling Signal::connect
+struct CallSite {
+    // The source file, or the tag
+    const char *file{nullptr};
+    int line{0};
+
+    static CallSite
+    current(const char *file = __builtin_FILE(), int line = __builtin_LINE())
+    {
+        return {file, line};
+    }
+
+    // Groups listeners under tag instead of where they were connected, i.e.
+    // when every connect goes through the same helper function
+    static CallSite
+    tagged(const char *tag)
+    {
+        return {tag, 0};
+    }
+};
+
+namespace detail {
+
+struct CallSiteEntry {
+    std::string location;
+
+    // Bodies that have been created here and not yet destroyed, whether
+    // they're still connected or not
+    std::atomic<std::size_t> bodyCount{0};
+};
+
+inline std::string
+formatCallSite(CallSite site)
+{
+    if (site.file == nullptr) {
+        return "<unknown>";
+    }
+
+    if (site.line == 0) {
+        return site.file;
+    }
+
+    return std::string(site.file) + ":" + std::to_string(site.line);
+}
+
+}  // namespace detail
+
+/// Registry of listener call sites and signals, for finding listener leaks
+// Every callback body counts towards the call site that connected it until
+// it is destroyed, so both listeners that never get disconnected and
+// disconnected bodies that are never swept show up.
+class LeakDetector
+{
+public:
+    struct CallSiteCount {
+        std::string location;
+        std::size_t bodyCount;
+    };
+
+    struct GrowingSignal {
+        const void *signal;
+        std::string createdAt;
+
+        // Bodies the signal stores right now, including disconnected ones
+        std::size_t bodyCount;
+
+        // Number of checkGrowth calls in a row that saw it grow
+        std::size_t growthStreak;
+    };
+
+    static LeakDetector &
+    instance()
+    {
+        // Never destroyed, signals with static storage may outlive it
+        static auto *detector = new LeakDetector;
+
+        return *detector;
+    }
+
+    LeakDetector(const LeakDetector &other) = delete;
+    LeakDetector &operator=(const LeakDetector &other) = delete;
+
+    // Call sites with living bodies, the most bodies first
+    [[nodiscard]] std::vector<CallSiteCount>
+    getCallSiteCounts() const
+    {
+        std::vector<CallSiteCount> counts;
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+
+            for (const auto &[key, entry] : this->callSites) {
+                auto count = entry.bodyCount.load(std::memory_order_relaxed);
+                if (count != 0) {
+                    counts.push_back({entry.location, count});
+                }
+            }
+        }
+
+        std::stable_sort(counts.begin(), counts.end(),
+                         [](const auto &a, const auto &b) {
+                             return a.bodyCount > b.bodyCount;
+                         });
+
+        return counts;
+    }
+
+    // Compares the number of bodies of every signal to the previous check
+    // Returns the signals that grew in at least minimumStreak checks in a
+    // row, so call this periodically, i.e. once a minute
+    std::vector<GrowingSignal>
+    checkGrowth(std::size_t minimumStreak = 3)
+    {
+        std::vector<GrowingSignal> growing;
+
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        for (auto &[signal, entry] : this->signals) {
+            auto count = entry.countBodies(signal);
+
+            if (count > entry.lastCount) {
+                ++entry.growthStreak;
+            } else {
+                entry.growthStreak = 0;
+            }
+            entry.lastCount = count;
+
+            if (entry.growthStreak >= minimumStreak) {
+                growing.push_back(
+                    {signal, entry.createdAt, count, entry.growthStreak});
+            }
+        }
+
+        return growing;
+    }
+
+    // Writes the call site counts and the result of checkGrowth to out
+    void
+    dump(std::ostream &out, std::size_t minimumStreak = 3)
+    {
+        out << "Listener bodies by call site:\n";
+        for (const auto &site : this->getCallSiteCounts()) {
+            out << "  " << site.bodyCount << "\t" << site.location << "\n";
+        }
+
+        auto growing = this->checkGrowth(minimumStreak);
+        if (growing.empty()) {
+            return;
+        }
+
+        out << "Signals that keep growing:\n";
+        for (const auto &signal : growing) {
+            out << "  " << signal.signal << " created at " << signal.createdAt
+                << ": " << signal.bodyCount << " bodies, grew "
+                << signal.growthStreak << " checks in a row\n";
+        }
+    }
+
+    // Used by the signals, not meant to be called directly
+
+    detail::CallSiteEntry *
+    acquireCallSite(CallSite site)
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        auto [it, inserted] = this->callSites.try_emplace(
+            {site.file != nullptr ? site.file : "", site.line});
+        if (inserted) {
+            it->second.location = detail::formatCallSite(site);
+        }
+
+        return &it->second;
+    }
+
+    void
+    addSignal(const void *signal, CallSite site,
+              std::size_t (*countBodies)(const void *))
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        this->signals[signal] = {detail::formatCallSite(site), countBodies, 0,
+                                 0};
+    }
+
+    void
+    removeSignal(const void *signal)
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        this->signals.erase(signal);
+    }
+
+private:
+    struct SignalEntry {
+        std::string createdAt;
+
+        // Locks the signal, so signals must never call into the detector
+        // while holding their own lock
+        std::size_t (*countBodies)(const void *);
+
+        std::size_t lastCount;
+        std::size_t growthStreak;
+    };
+
+    LeakDetector() = default;
+
+    mutable std::mutex mutex;
+
+    // Entries are never removed, bodies point straight at them
+    std::map<std::pair<std::string, int>, detail::CallSiteEntry> callSites;
+
+    std::map<const void *, SignalEntry> signals;
+};
+
+#else
+
+// Takes no space and records nothing without the leak detector
+struct CallSite {
+    static CallSite
+    current()
+    {
+        return {};
+    }
+
+    static CallSite
+    tagged(const char * /*tag*/)
+    {
+        return {};
+    }
+};
+
+#endif
+
+}  // namespace Signals
+}  // namespace pajlada
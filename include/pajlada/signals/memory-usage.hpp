@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace pajlada {
+namespace Signals {
+
+/// Snapshot of what a signal or SignalHolder keeps in memory
+// Counts are exact at the time of the call, bytes are an estimate: they cover
+// the object itself, its listener storage and the listener bodies, but not
+// anything a callback allocated on its own (i.e. a std::function's captures).
+struct MemoryUsage {
+    // Listeners that are connected, including blocked ones
+    std::size_t liveListeners{0};
+
+    // Listeners that got disconnected but are still stored, waiting to be
+    // swept by the next invoke, connect or compact
+    std::size_t deadListeners{0};
+
+    // Number of listeners the storage has room for without growing
+    std::size_t capacity{0};
+
+    std::size_t estimatedBytes{0};
+};
+
+namespace detail {
+
+// Frees the unused capacity of values
+// std::vector::shrink_to_fit is only a request, and libstdc++ ignores it when
+// building without exceptions
+template <typename T>
+void
+shrinkToFit(std::vector<T> &values)
+{
+    if (values.capacity() == values.size()) {
+        return;
+    }
+
+    std::vector<T>(std::make_move_iterator(values.begin()),
+                   std::make_move_iterator(values.end()))
+        .swap(values);
+}
+
+}  // namespace detail
+
+}  // namespace Signals
+}  // namespace pajlada
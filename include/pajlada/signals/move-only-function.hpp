@@ -0,0 +1,244 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<version>)
+#include <version>
+#endif
+
+namespace pajlada {
+namespace Signals {
+
+#if defined(__cpp_lib_move_only_function)
+
+template <typename Signature>
+using MoveOnlyFunction = std::move_only_function<Signature>;
+
+#else
+
+template <typename Signature>
+class MoveOnlyFunction;
+
+/// Minimal stand-in for C++23's std::move_only_function
+// Callables that are small enough and nothrow-movable are stored inline,
+// anything else is moved into a heap allocation
+template <typename R, typename... Args>
+class MoveOnlyFunction<R(Args...)>
+{
+    static constexpr std::size_t inlineSize = 4 * sizeof(void *);
+    static constexpr std::size_t inlineAlign = alignof(std::max_align_t);
+
+    template <typename F>
+    static constexpr bool storedInline =
+        sizeof(F) <= inlineSize && alignof(F) <= inlineAlign &&
+        std::is_nothrow_move_constructible_v<F>;
+
+    struct VTable {
+        R (*invoke)(void *storage, Args &&...args);
+
+        // Move-constructs dst from src, then destroys src
+        void (*relocate)(void *dst, void *src) noexcept;
+
+        void (*destroy)(void *storage) noexcept;
+    };
+
+    template <typename F>
+    static R
+    call(F &f, Args &&...args)
+    {
+        if constexpr (std::is_void_v<R>) {
+            std::invoke(f, std::forward<Args>(args)...);
+        } else {
+            return std::invoke(f, std::forward<Args>(args)...);
+        }
+    }
+
+    template <typename F>
+    struct InlineStorage {
+        static F &
+        get(void *storage) noexcept
+        {
+            return *std::launder(reinterpret_cast<F *>(storage));
+        }
+
+        static R
+        invoke(void *storage, Args &&...args)
+        {
+            return call(get(storage), std::forward<Args>(args)...);
+        }
+
+        static void
+        relocate(void *dst, void *src) noexcept
+        {
+            ::new (dst) F(std::move(get(src)));
+            get(src).~F();
+        }
+
+        static void
+        destroy(void *storage) noexcept
+        {
+            get(storage).~F();
+        }
+
+        static const VTable *
+        vtable() noexcept
+        {
+            static constexpr VTable table{&invoke, &relocate, &destroy};
+            return &table;
+        }
+    };
+
+    template <typename F>
+    struct HeapStorage {
+        static F *&
+        get(void *storage) noexcept
+        {
+            return *std::launder(reinterpret_cast<F **>(storage));
+        }
+
+        static R
+        invoke(void *storage, Args &&...args)
+        {
+            return call(*get(storage), std::forward<Args>(args)...);
+        }
+
+        static void
+        relocate(void *dst, void *src) noexcept
+        {
+            ::new (dst) F *(get(src));
+        }
+
+        static void
+        destroy(void *storage) noexcept
+        {
+            delete get(storage);
+        }
+
+        static const VTable *
+        vtable() noexcept
+        {
+            static constexpr VTable table{&invoke, &relocate, &destroy};
+            return &table;
+        }
+    };
+
+    template <typename F>
+    static bool
+    isNull(const F &f) noexcept
+    {
+        if constexpr (std::is_pointer_v<F> || std::is_member_pointer_v<F>) {
+            return f == nullptr;
+        } else {
+            return false;
+        }
+    }
+
+public:
+    MoveOnlyFunction() noexcept = default;
+
+    MoveOnlyFunction(std::nullptr_t) noexcept
+    {
+    }
+
+    template <typename F, typename Decayed = std::decay_t<F>,
+              typename = std::enable_if_t<
+                  !std::is_same_v<Decayed, MoveOnlyFunction> &&
+                  std::is_invocable_r_v<R, Decayed &, Args...>>>
+    MoveOnlyFunction(F &&f)
+    {
+        if (isNull(f)) {
+            return;
+        }
+
+        if constexpr (storedInline<Decayed>) {
+            ::new (static_cast<void *>(this->storage))
+                Decayed(std::forward<F>(f));
+            this->vtable = InlineStorage<Decayed>::vtable();
+        } else {
+            ::new (static_cast<void *>(this->storage))
+                Decayed *(new Decayed(std::forward<F>(f)));
+            this->vtable = HeapStorage<Decayed>::vtable();
+        }
+    }
+
+    MoveOnlyFunction(MoveOnlyFunction &&other) noexcept
+    {
+        this->takeFrom(other);
+    }
+
+    MoveOnlyFunction &
+    operator=(MoveOnlyFunction &&other) noexcept
+    {
+        if (&other == this) {
+            return *this;
+        }
+
+        this->reset();
+        this->takeFrom(other);
+        return *this;
+    }
+
+    MoveOnlyFunction &
+    operator=(std::nullptr_t) noexcept
+    {
+        this->reset();
+        return *this;
+    }
+
+    MoveOnlyFunction(const MoveOnlyFunction &other) = delete;
+    MoveOnlyFunction &operator=(const MoveOnlyFunction &other) = delete;
+
+    ~MoveOnlyFunction()
+    {
+        this->reset();
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return this->vtable != nullptr;
+    }
+
+    R
+    operator()(Args... args)
+    {
+        assert(this->vtable != nullptr);
+
+        return this->vtable->invoke(this->storage,
+                                    std::forward<Args>(args)...);
+    }
+
+private:
+    alignas(inlineAlign) unsigned char storage[inlineSize];
+    const VTable *vtable{nullptr};
+
+    void
+    reset() noexcept
+    {
+        if (this->vtable != nullptr) {
+            this->vtable->destroy(this->storage);
+            this->vtable = nullptr;
+        }
+    }
+
+    void
+    takeFrom(MoveOnlyFunction &other) noexcept
+    {
+        if (other.vtable == nullptr) {
+            return;
+        }
+
+        other.vtable->relocate(this->storage, other.storage);
+        this->vtable = other.vtable;
+        other.vtable = nullptr;
+    }
+};
+
+#endif
+
+}  // namespace Signals
+}  // namespace pajlada
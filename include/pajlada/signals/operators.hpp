@@ -0,0 +1,385 @@
+#pragma once
+
+#include "pajlada/signals/connection.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace pajlada {
+namespace Signals {
+
+namespace detail {
+
+template <typename... Ts>
+struct TypeList {
+};
+
+// Calls the listener at the end of a pipeline
+template <typename Listener>
+struct PipelineSink {
+    Listener listener;
+
+    template <typename... Values>
+    Propagation
+    operator()(Values &&...values)
+    {
+        return invokeListener(this->listener, std::forward<Values>(values)...);
+    }
+
+    [[nodiscard]] bool
+    isExhausted() const
+    {
+        return false;
+    }
+};
+
+template <typename F, typename Next>
+struct MapStage {
+    F func;
+    Next next;
+
+    template <typename... Values>
+    Propagation
+    operator()(Values &&...values)
+    {
+        return this->next(
+            std::invoke(this->func, std::forward<Values>(values)...));
+    }
+
+    [[nodiscard]] bool
+    isExhausted() const
+    {
+        return this->next.isExhausted();
+    }
+};
+
+template <typename F>
+struct MapOperator {
+    F func;
+
+    template <typename Input>
+    struct OutputOf;
+
+    template <typename... Ts>
+    struct OutputOf<TypeList<Ts...>> {
+        using type = TypeList<std::invoke_result_t<F &, Ts...>>;
+    };
+
+    template <typename Input, typename Next>
+    auto
+    bind(Next &&next) &&
+    {
+        return MapStage<F, std::decay_t<Next>>{std::move(this->func),
+                                               std::forward<Next>(next)};
+    }
+};
+
+template <typename F, typename Next>
+struct FilterStage {
+    F predicate;
+    Next next;
+
+    template <typename... Values>
+    Propagation
+    operator()(Values &&...values)
+    {
+        if (!std::invoke(this->predicate, std::as_const(values)...)) {
+            return Propagation::Continue;
+        }
+
+        return this->next(std::forward<Values>(values)...);
+    }
+
+    [[nodiscard]] bool
+    isExhausted() const
+    {
+        return this->next.isExhausted();
+    }
+};
+
+template <typename F>
+struct FilterOperator {
+    F predicate;
+
+    template <typename Input>
+    struct OutputOf {
+        using type = Input;
+    };
+
+    template <typename Input, typename Next>
+    auto
+    bind(Next &&next) &&
+    {
+        return FilterStage<F, std::decay_t<Next>>{std::move(this->predicate),
+                                                  std::forward<Next>(next)};
+    }
+};
+
+template <typename Next>
+struct TakeStage {
+    std::size_t remaining;
+    Next next;
+
+    template <typename... Values>
+    Propagation
+    operator()(Values &&...values)
+    {
+        if (this->remaining == 0) {
+            return Propagation::Continue;
+        }
+
+        --this->remaining;
+        return this->next(std::forward<Values>(values)...);
+    }
+
+    [[nodiscard]] bool
+    isExhausted() const
+    {
+        return this->remaining == 0 || this->next.isExhausted();
+    }
+};
+
+struct TakeOperator {
+    std::size_t count;
+
+    template <typename Input>
+    struct OutputOf {
+        using type = Input;
+    };
+
+    template <typename Input, typename Next>
+    auto
+    bind(Next &&next) &&
+    {
+        return TakeStage<std::decay_t<Next>>{this->count,
+                                             std::forward<Next>(next)};
+    }
+};
+
+template <typename Input, typename Next>
+struct DistinctStage;
+
+template <typename... Ts, typename Next>
+struct DistinctStage<TypeList<Ts...>, Next> {
+    Next next;
+    std::optional<std::tuple<std::decay_t<Ts>...>> last;
+
+    template <typename... Values>
+    Propagation
+    operator()(Values &&...values)
+    {
+        if (this->last && *this->last == std::tie(std::as_const(values)...)) {
+            return Propagation::Continue;
+        }
+
+        this->last.emplace(std::as_const(values)...);
+        return this->next(std::forward<Values>(values)...);
+    }
+
+    [[nodiscard]] bool
+    isExhausted() const
+    {
+        return this->next.isExhausted();
+    }
+};
+
+struct DistinctOperator {
+    template <typename Input>
+    struct OutputOf {
+        using type = Input;
+    };
+
+    template <typename Input, typename Next>
+    auto
+    bind(Next &&next) &&
+    {
+        return DistinctStage<Input, std::decay_t<Next>>{
+            std::forward<Next>(next), std::nullopt};
+    }
+};
+
+template <typename T, typename F, typename Next>
+struct ScanStage {
+    T accumulator;
+    F func;
+    Next next;
+
+    template <typename... Values>
+    Propagation
+    operator()(Values &&...values)
+    {
+        this->accumulator = std::invoke(this->func, std::move(this->accumulator),
+                                        std::forward<Values>(values)...);
+        return this->next(std::as_const(this->accumulator));
+    }
+
+    [[nodiscard]] bool
+    isExhausted() const
+    {
+        return this->next.isExhausted();
+    }
+};
+
+template <typename T, typename F>
+struct ScanOperator {
+    T initial;
+    F func;
+
+    template <typename Input>
+    struct OutputOf {
+        using type = TypeList<const T &>;
+    };
+
+    template <typename Input, typename Next>
+    auto
+    bind(Next &&next) &&
+    {
+        return ScanStage<T, F, std::decay_t<Next>>{std::move(this->initial),
+                                                   std::move(this->func),
+                                                   std::forward<Next>(next)};
+    }
+};
+
+// Wraps the listener in the operators, starting with the last one
+// Input is the list of types the first operator is called with
+template <typename Input, typename Listener>
+auto
+fuseOperators(Listener &&listener)
+{
+    return PipelineSink<std::decay_t<Listener>>{
+        std::forward<Listener>(listener)};
+}
+
+template <typename Input, typename Listener, typename Operator,
+          typename... Rest>
+auto
+fuseOperators(Listener &&listener, Operator &&op, Rest &&...rest)
+{
+    using Output = typename std::decay_t<Operator>::template OutputOf<
+        Input>::type;
+
+    auto next = fuseOperators<Output>(std::forward<Listener>(listener),
+                                      std::forward<Rest>(rest)...);
+
+    return std::move(op).template bind<Input>(std::move(next));
+}
+
+}  // namespace detail
+
+/// Operator pipelines
+// Describes how a signal's values are transformed before they reach a
+// listener. Nothing is connected until connect is called, which fuses all
+// operators and the listener into a single callback, so each invoke of the
+// signal costs one listener call no matter how many operators there are.
+// Usage:
+//   auto conn = pipe(signal)
+//                   .filter([](int v) { return v > 0; })
+//                   .map([](int v) { return v * 2; })
+//                   .take(3)
+//                   .connect([](int v) { ... });
+// take, distinct and scan keep their state in the fused callback, so they
+// expect the signal not to be invoked from several threads at once.
+// Like any other listener, a pipeline stays connected until its Connection
+// is disconnected (e.g. through a ScopedConnection) or a take is used up.
+template <typename SignalType, typename Input, typename... Operators>
+class Pipeline
+{
+    template <typename Operator>
+    using Then = Pipeline<SignalType, Input, Operators..., Operator>;
+
+public:
+    Pipeline(SignalType &_signal, std::tuple<Operators...> &&_operators)
+        : signal(_signal)
+        , operators(std::move(_operators))
+    {
+    }
+
+    // Passes func's result on instead of the values
+    template <typename F>
+    [[nodiscard]] Then<detail::MapOperator<std::decay_t<F>>>
+    map(F &&func) &&
+    {
+        return this->then(
+            detail::MapOperator<std::decay_t<F>>{std::forward<F>(func)});
+    }
+
+    // Only passes the values on if predicate returns true for them
+    template <typename F>
+    [[nodiscard]] Then<detail::FilterOperator<std::decay_t<F>>>
+    filter(F &&predicate) &&
+    {
+        return this->then(
+            detail::FilterOperator<std::decay_t<F>>{std::forward<F>(predicate)});
+    }
+
+    // Only passes the first count values on
+    // The listener disconnects itself after passing on the last one
+    [[nodiscard]] Then<detail::TakeOperator>
+    take(std::size_t count) &&
+    {
+        return this->then(detail::TakeOperator{count});
+    }
+
+    // Skips values that are equal to the last values passed on
+    [[nodiscard]] Then<detail::DistinctOperator>
+    distinct() &&
+    {
+        return this->then(detail::DistinctOperator{});
+    }
+
+    // Passes on the running result of func(accumulator, values...),
+    // starting from initial
+    template <typename T, typename F>
+    [[nodiscard]] Then<detail::ScanOperator<std::decay_t<T>, std::decay_t<F>>>
+    scan(T &&initial, F &&func) &&
+    {
+        return this->then(
+            detail::ScanOperator<std::decay_t<T>, std::decay_t<F>>{
+                std::forward<T>(initial), std::forward<F>(func)});
+    }
+
+    // Connects listener through all operators as a single callback
+    template <typename Listener>
+    [[nodiscard]] Connection
+    connect(Listener &&listener, CallSite site = CallSite::current()) &&
+    {
+        auto fused = std::apply(
+            [&listener](auto &...ops) {
+                return detail::fuseOperators<Input>(
+                    std::forward<Listener>(listener), std::move(ops)...);
+            },
+            this->operators);
+
+        return detail::connectAt(this->signal, std::move(fused), site);
+    }
+
+private:
+    SignalType &signal;
+    std::tuple<Operators...> operators;
+
+    template <typename Operator>
+    Then<Operator>
+    then(Operator &&op)
+    {
+        return Then<Operator>(
+            this->signal,
+            std::tuple_cat(std::move(this->operators),
+                           std::make_tuple(std::forward<Operator>(op))));
+    }
+};
+
+// Starts an operator pipeline on signal, see Pipeline
+// Works with any signal type whose template arguments are its value types
+template <template <typename...> class SignalTemplate, typename... Args>
+[[nodiscard]] Pipeline<SignalTemplate<Args...>, detail::TypeList<Args...>>
+pipe(SignalTemplate<Args...> &signal)
+{
+    return {signal, std::tuple<>()};
+}
+
+}  // namespace Signals
+}  // namespace pajlada
@@ -0,0 +1,182 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include "pajlada/signals/scoped-connection.hpp"
+#include "pajlada/signals/signal.hpp"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace pajlada {
+namespace Signals {
+
+/// Pollable Signals (Linux only)
+// Queues invokes from any thread and wakes a consumer through an eventfd,
+// meant for threads that run their own epoll/poll loop.
+// invoke is a lock-free push. The eventfd is only written when the queue
+// goes from empty to non-empty, so a burst of invokes costs one syscall.
+// The consumer waits for getFd() to become readable, then calls drain.
+// Only one thread may drain at a time.
+template <typename... Args>
+class PollableSignal
+{
+    using Values = std::tuple<std::decay_t<Args>...>;
+
+    struct Node {
+        Values values;
+        Node *next;
+    };
+
+public:
+    PollableSignal()
+        : fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    {
+    }
+
+    // Queues every invoke of source
+    explicit PollableSignal(Signal<Args...> &source)
+        : PollableSignal()
+    {
+        this->sourceConnection = source.connect([this](Args... args) {
+            this->invoke(std::forward<Args>(args)...);
+        });
+    }
+
+    ~PollableSignal()
+    {
+        // Stop queueing before the queue goes away
+        this->sourceConnection = ScopedConnection();
+
+        deleteList(this->head.load(std::memory_order_acquire));
+
+        if (this->fd >= 0) {
+            close(this->fd);
+        }
+    }
+
+    PollableSignal(const PollableSignal &other) = delete;
+    PollableSignal &operator=(const PollableSignal &other) = delete;
+
+    void
+    invoke(Args... args)
+    {
+        auto *pushed = new Node{Values(std::forward<Args>(args)...), nullptr};
+
+        // pushed belongs to the consumer as soon as it's published, so keep
+        // the previous head around instead of reading pushed->next again
+        auto *previous = this->head.load(std::memory_order_relaxed);
+        do {
+            pushed->next = previous;
+        } while (!this->head.compare_exchange_weak(previous, pushed,
+                                                   std::memory_order_release,
+                                                   std::memory_order_relaxed));
+
+        if (previous == nullptr) {
+            // The consumer may be asleep
+            this->wake();
+        }
+    }
+
+    // Calls func with the values of every queued invoke, oldest first
+    // Returns the number of invokes that were drained
+    template <typename Func>
+    std::size_t
+    drain(Func &&func)
+    {
+        // Clear the wakeup before taking the queue, so an invoke racing with
+        // us either lands in this drain or leaves the fd readable
+        this->clearWakeup();
+
+        auto *node = this->head.exchange(nullptr, std::memory_order_acquire);
+
+        // The queue was built newest-first, reverse it
+        Node *ordered = nullptr;
+        while (node != nullptr) {
+            auto *next = node->next;
+            node->next = ordered;
+            ordered = node;
+            node = next;
+        }
+
+        std::size_t count = 0;
+        while (ordered != nullptr) {
+            auto *next = ordered->next;
+            std::apply(func, std::move(ordered->values));
+            delete ordered;
+            ordered = next;
+            ++count;
+        }
+
+        return count;
+    }
+
+    // Becomes readable when there is something to drain
+    // -1 if the eventfd could not be created, drain still works then but
+    // nothing wakes the consumer up
+    [[nodiscard]] int
+    getFd() const
+    {
+        return this->fd;
+    }
+
+    [[nodiscard]] bool
+    isEmpty() const
+    {
+        return this->head.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    int fd;
+    std::atomic<Node *> head{nullptr};
+    ScopedConnection sourceConnection;
+
+    void
+    wake()
+    {
+        if (this->fd < 0) {
+            return;
+        }
+
+        uint64_t one = 1;
+        // Can only fail if the counter would overflow, it's readable then
+        [[maybe_unused]] auto written = write(this->fd, &one, sizeof(one));
+    }
+
+    void
+    clearWakeup()
+    {
+        if (this->fd < 0) {
+            return;
+        }
+
+        uint64_t counter = 0;
+        // Fails with EAGAIN if nothing was written, that's fine
+        [[maybe_unused]] auto bytesRead =
+            read(this->fd, &counter, sizeof(counter));
+    }
+
+    static void
+    deleteList(Node *node)
+    {
+        while (node != nullptr) {
+            auto *next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+};
+
+using NoArgPollableSignal = PollableSignal<>;
+
+}  // namespace Signals
+}  // namespace pajlada
+
+#endif
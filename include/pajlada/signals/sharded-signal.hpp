@@ -0,0 +1,210 @@
+#pragma once
+
+#include "pajlada/signals/connection.hpp"
+#include "pajlada/signals/memory-usage.hpp"
+#include "pajlada/signals/signal.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace pajlada {
+namespace Signals {
+
+/// Sharded Signals (for signals that are connected to from many threads)
+// Listeners are spread over several independently locked shards, picked by
+// the connecting thread, so concurrent connects don't contend on one mutex.
+// invoke walks every shard. Listeners are called in connect order within a
+// shard, but there is no ordering between shards. A listener returning
+// Propagation::Stop skips all remaining listeners, in every shard.
+template <typename... Args>
+class ShardedSignal
+{
+public:
+    using CallbackBodyType = detail::CallbackBody<Args...>;
+
+    // shardCount is rounded up to a power of two, 0 picks one per hardware thread
+    // site is where the signal was created, the shards are reported together
+    // as one signal by LeakDetector::checkGrowth
+    explicit ShardedSignal(std::size_t shardCount = 0,
+                           [[maybe_unused]] CallSite site = CallSite::current())
+    {
+        if (shardCount == 0) {
+            shardCount = std::thread::hardware_concurrency();
+        }
+
+        std::size_t roundedCount = 1;
+        while (roundedCount < shardCount) {
+            roundedCount <<= 1;
+        }
+
+        this->shards = std::make_unique<Shard[]>(roundedCount);
+        this->shardMask = roundedCount - 1;
+
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+        LeakDetector::instance().addSignal(this, site, &countStored);
+#endif
+    }
+
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+    ~ShardedSignal()
+    {
+        // Before the shards go, the detector locks them while it holds its lock
+        LeakDetector::instance().removeSignal(this);
+    }
+#endif
+
+    ShardedSignal(const ShardedSignal &other) = delete;
+    ShardedSignal &operator=(const ShardedSignal &other) = delete;
+
+    template <typename Callback>
+    [[nodiscard]] Connection
+    connect(Callback &&func, CallSite site = CallSite::current())
+    {
+        using Func = std::decay_t<Callback>;
+
+        static_assert(std::is_invocable_v<Func &, Args...>,
+                      "Callback must be callable with the signal's arguments");
+
+        return this->getLocalShard().add(
+            detail::makeBody<detail::FunctionCallbackBody<Func, Args...>>(
+                std::forward<Callback>(func)),
+            0, site);
+    }
+
+    // Usage: signal.connect<&Foo::onBar>(foo)
+    template <auto Method, typename T>
+    [[nodiscard]] Connection
+    connect(T *object, CallSite site = CallSite::current())
+    {
+        static_assert(std::is_invocable_v<decltype(Method), T *, Args...>,
+                      "Method must be callable with the signal's arguments");
+
+        return this->getLocalShard().add(
+            detail::makeBody<detail::MemberCallbackBody<Method, T, Args...>>(
+                object),
+            0, site);
+    }
+
+    void
+    invoke(Args... args)
+    {
+        for (std::size_t i = 0; i <= this->shardMask; ++i) {
+            auto &bodies = this->shards[i].bodies;
+
+            if (bodies.isEmpty()) {
+                continue;
+            }
+
+            auto activeBodies = bodies.getActiveBodies();
+
+            for (const auto &cb : activeBodies) {
+                if (cb->invoke(args...) == Propagation::Stop) {
+                    return;
+                }
+            }
+        }
+    }
+
+    // Number of connected listeners over all shards, including blocked ones
+    [[nodiscard]] std::size_t
+    getListenerCount() const
+    {
+        std::size_t count = 0;
+
+        for (std::size_t i = 0; i <= this->shardMask; ++i) {
+            count += this->shards[i].bodies.getTracker().getCount();
+        }
+
+        return count;
+    }
+
+    [[nodiscard]] std::size_t
+    getShardCount() const
+    {
+        return this->shardMask + 1;
+    }
+
+    // Summed over all shards
+    [[nodiscard]] MemoryUsage
+    getMemoryUsage() const
+    {
+        MemoryUsage usage;
+
+        for (std::size_t i = 0; i <= this->shardMask; ++i) {
+            auto shardUsage = this->shards[i].bodies.getMemoryUsage();
+
+            usage.liveListeners += shardUsage.liveListeners;
+            usage.deadListeners += shardUsage.deadListeners;
+            usage.capacity += shardUsage.capacity;
+            usage.estimatedBytes += shardUsage.estimatedBytes;
+        }
+        usage.estimatedBytes +=
+            sizeof(*this) + this->getShardCount() * sizeof(Shard);
+
+        return usage;
+    }
+
+    // Drops disconnected listeners and gives unused storage back, shard by
+    // shard
+    void
+    compact()
+    {
+        for (std::size_t i = 0; i <= this->shardMask; ++i) {
+            this->shards[i].bodies.compact();
+        }
+    }
+
+private:
+    // Padded so neighbouring shards' mutexes don't share a cache line
+    struct alignas(64) Shard {
+        detail::CallbackBodyList<CallbackBodyType> bodies{
+            detail::UntrackedList{}};
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    std::size_t shardMask{0};
+
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+    // Bodies we're holding on to over all shards, for LeakDetector
+    static std::size_t
+    countStored(const void *self)
+    {
+        auto usage = static_cast<const ShardedSignal *>(self)->getMemoryUsage();
+
+        return usage.liveListeners + usage.deadListeners;
+    }
+#endif
+
+    detail::CallbackBodyList<CallbackBodyType> &
+    getLocalShard()
+    {
+        static thread_local const std::size_t threadHash =
+            mixHash(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+        return this->shards[threadHash & this->shardMask].bodies;
+    }
+
+    // Some standard libraries hash a thread id to its pthread_t pointer, whose
+    // low bits tend to be the same for every thread, so spread all bits over
+    // the low ones before masking (the splitmix64 finalizer)
+    static std::size_t
+    mixHash(std::size_t hash)
+    {
+        auto mixed = static_cast<uint64_t>(hash);
+        mixed = (mixed ^ (mixed >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        mixed = (mixed ^ (mixed >> 27)) * 0x94d049bb133111ebULL;
+        mixed ^= mixed >> 31;
+
+        return static_cast<std::size_t>(mixed);
+    }
+};
+
+using NoArgShardedSignal = ShardedSignal<>;
+
+}  // namespace Signals
+}  // namespace pajlada
@@ -0,0 +1,32 @@
+#pragma once
+
+namespace pajlada {
+namespace Signals {
+
+/// Blocks a signal for as long as the blocker is alive
+// Usage: SignalBlocker blocker(signal);
+template <typename SignalType>
+class SignalBlocker
+{
+    SignalType &signal;
+
+public:
+    explicit SignalBlocker(SignalType &_signal)
+        : signal(_signal)
+    {
+        this->signal.block();
+    }
+
+    ~SignalBlocker()
+    {
+        this->signal.unblock();
+    }
+
+    SignalBlocker(const SignalBlocker &other) = delete;
+    SignalBlocker &operator=(const SignalBlocker &other) = delete;
+    SignalBlocker(SignalBlocker &&other) = delete;
+    SignalBlocker &operator=(SignalBlocker &&other) = delete;
+};
+
+}  // namespace Signals
+}  // namespace pajlada
@@ -0,0 +1,508 @@
+#pragma once
+
+#include "pajlada/signals/signal.hpp"
+#include "pajlada/signals/signalholder.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace pajlada {
+namespace Signals {
+
+namespace detail {
+
+// The value a combinator keeps for one invoke of an input signal:
+// the argument itself for single-argument signals, a tuple otherwise
+template <typename... Args>
+struct InputValueOf {
+    using type = std::tuple<std::decay_t<Args>...>;
+};
+
+template <typename Arg>
+struct InputValueOf<Arg> {
+    using type = std::decay_t<Arg>;
+};
+
+template <typename SignalType>
+struct InputValue;
+
+template <template <typename...> class SignalTemplate, typename... Args>
+struct InputValue<SignalTemplate<Args...>> {
+    using type = typename InputValueOf<Args...>::type;
+};
+
+template <typename SignalType>
+using InputValueT = typename InputValue<SignalType>::type;
+
+/// Latest value of an input, readable while other threads write it
+// Writes to the same slot take turns, an odd sequence means one is running.
+// Readers retry until they copied the words without a write in between.
+template <typename T>
+class SeqlockSlot
+{
+    static constexpr std::size_t WORD_COUNT =
+        (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+public:
+    void
+    store(const T &value)
+    {
+        std::array<uint64_t, WORD_COUNT> copy{};
+        std::memcpy(copy.data(), &value, sizeof(T));
+
+        auto current = this->sequence.load(std::memory_order_relaxed);
+        do {
+            while ((current & 1) != 0) {
+                std::this_thread::yield();
+                current = this->sequence.load(std::memory_order_relaxed);
+            }
+        } while (!this->sequence.compare_exchange_weak(
+            current, current + 1, std::memory_order_acquire,
+            std::memory_order_relaxed));
+
+        // Release, so a reader that sees any of the new words also sees the
+        // odd sequence when it checks again. Costs nothing extra on x86.
+        for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+            this->words[i].store(copy[i], std::memory_order_release);
+        }
+
+        this->sequence.store(current + 2, std::memory_order_release);
+    }
+
+    T
+    load() const
+    {
+        std::array<uint64_t, WORD_COUNT> copy{};
+
+        uint32_t before = 0;
+        uint32_t after = 0;
+        do {
+            before = this->sequence.load(std::memory_order_acquire);
+
+            for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+                copy[i] = this->words[i].load(std::memory_order_acquire);
+            }
+
+            after = this->sequence.load(std::memory_order_relaxed);
+        } while (before != after || (before & 1) != 0);
+
+        T value;
+        std::memcpy(&value, copy.data(), sizeof(T));
+        return value;
+    }
+
+private:
+    std::atomic<uint32_t> sequence{0};
+    std::array<std::atomic<uint64_t>, WORD_COUNT> words{};
+};
+
+/// Same as SeqlockSlot for values that can't be copied word by word
+// The mutex is per input, so inputs still don't contend with each other
+template <typename T>
+class LockedSlot
+{
+public:
+    void
+    store(const T &value)
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        this->value = value;
+    }
+
+    T
+    load() const
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        return *this->value;
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::optional<T> value;
+};
+
+template <typename T>
+using LatestSlot =
+    std::conditional_t<std::is_trivially_copyable_v<T> &&
+                           std::is_default_constructible_v<T>,
+                       SeqlockSlot<T>, LockedSlot<T>>;
+
+}  // namespace detail
+
+/// Combines the latest values of several signals
+// Once every input has been invoked at least once, each invoke of any input
+// invokes the combined signal with the latest value of every input.
+// An input's value is its argument, or a tuple of its arguments if it has
+// several (see detail::InputValue).
+// Inputs are tracked without a shared lock: trivially copyable values are
+// kept in a seqlock, others behind a mutex per input. Invokes of different
+// inputs on different threads may reach the listeners in any order.
+// Usage:
+//   auto latest = combineLatest(widthChanged, heightChanged);
+//   auto conn = latest.getSignal().connect([](const auto &size) {
+//       auto [width, height] = size;
+//   });
+template <typename... Inputs>
+class CombineLatest
+{
+    static_assert(sizeof...(Inputs) > 0 && sizeof...(Inputs) <= 64,
+                  "combineLatest takes between 1 and 64 signals");
+
+public:
+    using ValueType = std::tuple<detail::InputValueT<Inputs>...>;
+
+    explicit CombineLatest(Inputs &...inputs)
+    {
+        this->connectInputs(std::index_sequence_for<Inputs...>{}, inputs...);
+    }
+
+    ~CombineLatest()
+    {
+        this->inputConnections.clear();
+    }
+
+    CombineLatest(const CombineLatest &other) = delete;
+    CombineLatest &operator=(const CombineLatest &other) = delete;
+    CombineLatest(CombineLatest &&other) = delete;
+    CombineLatest &operator=(CombineLatest &&other) = delete;
+
+    Signal<const ValueType &> &
+    getSignal()
+    {
+        return this->signal;
+    }
+
+private:
+    static constexpr uint64_t ALL_SET =
+        sizeof...(Inputs) == 64 ? ~uint64_t(0)
+                                : (uint64_t(1) << sizeof...(Inputs)) - 1;
+
+    Signal<const ValueType &> signal;
+
+    std::tuple<detail::LatestSlot<detail::InputValueT<Inputs>>...> slots;
+
+    // One bit per input that has a value
+    std::atomic<uint64_t> setInputs{0};
+
+    // Declared last so the inputs are disconnected before anything else goes
+    SignalHolder inputConnections;
+
+    template <std::size_t... Is>
+    void
+    connectInputs(std::index_sequence<Is...> /*indices*/, Inputs &...inputs)
+    {
+        (this->inputConnections.managedConnect(
+             inputs,
+             [this](auto &&...args) {
+                 this->template update<Is>(
+                     std::forward<decltype(args)>(args)...);
+             }),
+         ...);
+    }
+
+    template <std::size_t I, typename... Values>
+    void
+    update(Values &&...values)
+    {
+        using Value = std::tuple_element_t<I, ValueType>;
+
+        std::get<I>(this->slots).store(Value(std::forward<Values>(values)...));
+
+        // Skips the read-modify-write once every input has a value
+        auto set = this->setInputs.load(std::memory_order_acquire);
+        if (set != ALL_SET) {
+            set = this->setInputs.fetch_or(uint64_t(1) << I,
+                                           std::memory_order_acq_rel) |
+                  (uint64_t(1) << I);
+            if (set != ALL_SET) {
+                return;
+            }
+        }
+
+        this->signal.invoke(
+            this->loadAll(std::index_sequence_for<Inputs...>{}));
+    }
+
+    template <std::size_t... Is>
+    ValueType
+    loadAll(std::index_sequence<Is...> /*indices*/) const
+    {
+        return ValueType(std::get<Is>(this->slots).load()...);
+    }
+};
+
+/// Pairs up the invokes of several signals
+// The nth invoke of the combined signal carries the values of the nth invoke
+// of every input. Values wait in a queue per input until every other input
+// caught up.
+// Pairing has to take a value from every input at once, so unlike
+// combineLatest, all inputs share one mutex. Listeners are called outside of
+// it, one row at a time and in order; a row completed while another thread is
+// calling listeners is handed to that thread.
+template <typename... Inputs>
+class Zip
+{
+    static_assert(sizeof...(Inputs) > 0, "zip takes at least one signal");
+
+public:
+    using ValueType = std::tuple<detail::InputValueT<Inputs>...>;
+
+    explicit Zip(Inputs &...inputs)
+    {
+        this->connectInputs(std::index_sequence_for<Inputs...>{}, inputs...);
+    }
+
+    ~Zip()
+    {
+        this->inputConnections.clear();
+    }
+
+    Zip(const Zip &other) = delete;
+    Zip &operator=(const Zip &other) = delete;
+    Zip(Zip &&other) = delete;
+    Zip &operator=(Zip &&other) = delete;
+
+    Signal<const ValueType &> &
+    getSignal()
+    {
+        return this->signal;
+    }
+
+private:
+    Signal<const ValueType &> signal;
+
+    std::mutex mutex;
+    std::tuple<std::deque<detail::InputValueT<Inputs>>...> queues;
+
+    // Completed rows waiting to be delivered, and whether a thread is
+    // delivering them right now
+    std::deque<ValueType> rows;
+    bool delivering{false};
+
+    // Declared last so the inputs are disconnected before anything else goes
+    SignalHolder inputConnections;
+
+    template <std::size_t... Is>
+    void
+    connectInputs(std::index_sequence<Is...> /*indices*/, Inputs &...inputs)
+    {
+        (this->inputConnections.managedConnect(
+             inputs,
+             [this](auto &&...args) {
+                 this->template push<Is>(std::forward<decltype(args)>(args)...);
+             }),
+         ...);
+    }
+
+    template <std::size_t I, typename... Values>
+    void
+    push(Values &&...values)
+    {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+
+            std::get<I>(this->queues).emplace_back(
+                std::forward<Values>(values)...);
+
+            while (this->hasRowLocked(std::index_sequence_for<Inputs...>{})) {
+                this->rows.emplace_back(
+                    this->popRowLocked(std::index_sequence_for<Inputs...>{}));
+            }
+
+            if (this->delivering || this->rows.empty()) {
+                return;
+            }
+
+            this->delivering = true;
+        }
+
+        this->deliver();
+    }
+
+    void
+    deliver()
+    {
+        // Lets another thread take over if a listener throws
+        struct DeliveryGuard {
+            Zip *zip;
+            bool finished{false};
+
+            ~DeliveryGuard()
+            {
+                if (!this->finished) {
+                    std::unique_lock<std::mutex> lock(this->zip->mutex);
+                    this->zip->delivering = false;
+                }
+            }
+        } guard{this};
+
+        while (true) {
+            std::optional<ValueType> row;
+
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+
+                if (this->rows.empty()) {
+                    this->delivering = false;
+                    guard.finished = true;
+                    return;
+                }
+
+                row.emplace(std::move(this->rows.front()));
+                this->rows.pop_front();
+            }
+
+            this->signal.invoke(*row);
+        }
+    }
+
+    template <std::size_t... Is>
+    bool
+    hasRowLocked(std::index_sequence<Is...> /*indices*/) const
+    {
+        return (!std::get<Is>(this->queues).empty() && ...);
+    }
+
+    template <std::size_t... Is>
+    ValueType
+    popRowLocked(std::index_sequence<Is...> /*indices*/)
+    {
+        ValueType row(std::move(std::get<Is>(this->queues).front())...);
+        (std::get<Is>(this->queues).pop_front(), ...);
+        return row;
+    }
+};
+
+/// Fires once every input has been invoked
+// The combined signal is invoked a single time, with the value of each
+// input's first invoke. Later invokes of the inputs are ignored.
+// Inputs are tracked with atomics only, the last input to arrive invokes the
+// combined signal on its own thread.
+// Usage:
+//   auto ready = whenAll(configLoaded, authReady, cacheWarm);
+//   auto conn = ready.getSignal().connect([](const auto &) { start(); });
+template <typename... Inputs>
+class WhenAll
+{
+    static_assert(sizeof...(Inputs) > 0, "whenAll takes at least one signal");
+
+public:
+    using ValueType = std::tuple<detail::InputValueT<Inputs>...>;
+
+    explicit WhenAll(Inputs &...inputs)
+    {
+        this->connectInputs(std::index_sequence_for<Inputs...>{}, inputs...);
+    }
+
+    ~WhenAll()
+    {
+        this->inputConnections.clear();
+    }
+
+    WhenAll(const WhenAll &other) = delete;
+    WhenAll &operator=(const WhenAll &other) = delete;
+    WhenAll(WhenAll &&other) = delete;
+    WhenAll &operator=(WhenAll &&other) = delete;
+
+    // Listeners connected after every input arrived are not called
+    Signal<const ValueType &> &
+    getSignal()
+    {
+        return this->signal;
+    }
+
+    // Returns true once every input has been invoked
+    [[nodiscard]] bool
+    isDone() const
+    {
+        return this->remaining.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    Signal<const ValueType &> signal;
+
+    std::array<std::atomic<bool>, sizeof...(Inputs)> arrived{};
+    std::tuple<std::optional<detail::InputValueT<Inputs>>...> values;
+    std::atomic<std::size_t> remaining{sizeof...(Inputs)};
+
+    // Declared last so the inputs are disconnected before anything else goes
+    SignalHolder inputConnections;
+
+    template <std::size_t... Is>
+    void
+    connectInputs(std::index_sequence<Is...> /*indices*/, Inputs &...inputs)
+    {
+        (this->inputConnections.managedConnect(
+             inputs,
+             [this](auto &&...args) {
+                 this->template arrive<Is>(
+                     std::forward<decltype(args)>(args)...);
+             }),
+         ...);
+    }
+
+    template <std::size_t I, typename... Values>
+    void
+    arrive(Values &&...args)
+    {
+        if (this->arrived[I].load(std::memory_order_relaxed) ||
+            this->arrived[I].exchange(true, std::memory_order_relaxed)) {
+            return;
+        }
+
+        std::get<I>(this->values).emplace(std::forward<Values>(args)...);
+
+        // Publishes the value to whoever arrives last
+        if (this->remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+
+        this->signal.invoke(
+            this->takeAll(std::index_sequence_for<Inputs...>{}));
+    }
+
+    template <std::size_t... Is>
+    ValueType
+    takeAll(std::index_sequence<Is...> /*indices*/)
+    {
+        return ValueType(std::move(*std::get<Is>(this->values))...);
+    }
+};
+
+// The combinators can't be moved, these rely on guaranteed copy elision:
+//   auto latest = combineLatest(a, b);
+template <typename... Inputs>
+[[nodiscard]] CombineLatest<Inputs...>
+combineLatest(Inputs &...inputs)
+{
+    return CombineLatest<Inputs...>(inputs...);
+}
+
+template <typename... Inputs>
+[[nodiscard]] Zip<Inputs...>
+zip(Inputs &...inputs)
+{
+    return Zip<Inputs...>(inputs...);
+}
+
+template <typename... Inputs>
+[[nodiscard]] WhenAll<Inputs...>
+whenAll(Inputs &...inputs)
+{
+    return WhenAll<Inputs...>(inputs...);
+}
+
+}  // namespace Signals
+}  // namespace pajlada
@@ -1,87 +1,1083 @@
 #pragma once
 
 #include "pajlada/signals/connection.hpp"
+#include "pajlada/signals/invoke-completion.hpp"
+#include "pajlada/signals/memory-usage.hpp"
+#include "pajlada/signals/move-only-function.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
 namespace pajlada {
 namespace Signals {
 
+namespace detail {
+
+// Picks the CallbackBodyList constructor that doesn't register with the
+// LeakDetector, for signals made of several lists that register as a whole
+struct UntrackedList {
+};
+
+/// Thread-safe list of callback bodies, shared by the signal types
+// Disconnected bodies are swept lazily whenever the active bodies are collected
+// An in-place iteration walks the storage that was current when it started,
+// and a storage is never changed while an iteration walks it. Connecting or
+// sweeping meanwhile moves the bodies into a fresh storage instead, so a new
+// body is seen by every iteration that starts after it was added, and the old
+// storage is freed once the last iteration walking it is done.
+template <typename BodyType>
+class CallbackBodyList
+{
+public:
+    explicit CallbackBodyList([[maybe_unused]] CallSite site = CallSite())
+    {
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+        LeakDetector::instance().addSignal(this, site, &countStored);
+#endif
+    }
+
+    explicit CallbackBodyList(UntrackedList /*tag*/)
+    {
+    }
+
+    ~CallbackBodyList()
+    {
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+        // Before taking our own lock, the detector locks us while it holds its
+        LeakDetector::instance().removeSignal(this);
+#endif
+
+        // Bodies may outlive us if a Connection is holding them right now
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        for (auto &body : this->storage->bodies) {
+            body->detachTracker();
+            body->expire();
+        }
+
+        this->releaseLocked(this->storage);
+    }
+
+    CallbackBodyList(const CallbackBodyList &other) = delete;
+    CallbackBodyList &operator=(const CallbackBodyList &other) = delete;
+
+    // Bodies are kept sorted by descending priority, bodies with the same
+    // priority stay in the order they were added
+    Connection
+    add(BodyPtr<BodyType> &&body, int priority = 0,
+        [[maybe_unused]] CallSite site = CallSite())
+    {
+        body->setTracker(&this->tracker);
+        body->setPriority(priority);
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+        body->setCallSite(LeakDetector::instance().acquireCallSite(site));
+#endif
+
+        // Connected before it is published, so it can't be swept right away
+        Connection connection(body.get());
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+
+            auto &bodies = this->storage->bodies;
+
+            if (this->storage->refs > 1) {
+                // Being walked right now, the iterations keep the current
+                // storage while the new body goes into a fresh one
+                insertSorted(this->replaceStorageLocked(1)->bodies,
+                             std::move(body));
+            } else {
+                if (bodies.size() == bodies.capacity()) {
+                    // Make room by dropping disconnected bodies before
+                    // growing, invoke doesn't sweep a signal nobody listens to
+                    this->sweepLocked();
+                }
+
+                insertSorted(bodies, std::move(body));
+            }
+        }
+
+        return connection;
+    }
+
+    // Returns a snapshot of the connected and unblocked bodies, so callbacks
+    // are free to connect or disconnect while the snapshot is being invoked
+    std::vector<BodyPtr<BodyType>>
+    getActiveBodies()
+    {
+        std::vector<BodyPtr<BodyType>> activeBodies;
+
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        auto &bodies = this->storage->bodies;
+
+        // Some may be blocked or disconnected, but a single allocation is
+        // cheaper than growing the snapshot step by step
+        activeBodies.reserve(bodies.size());
+
+        if (this->storage->refs > 1) {
+            for (const auto &body : bodies) {
+                if (body->isConnected() && !body->isBlocked()) {
+                    activeBodies.emplace_back(body);
+                }
+            }
+
+            return activeBodies;
+        }
+
+        // Disconnected bodies are dropped in a single compacting pass
+        auto kept = bodies.begin();
+        for (auto &body : bodies) {
+            if (!body->isConnected()) {
+                // Already counted as disconnected, by its group or when it
+                // lost its last subscriber
+                body->expire();
+                continue;
+            }
+
+            if (!body->isBlocked()) {
+                activeBodies.emplace_back(body);
+            }
+
+            if (&*kept != &body) {
+                *kept = std::move(body);
+            }
+            ++kept;
+        }
+        bodies.erase(kept, bodies.end());
+
+        return activeBodies;
+    }
+
+    // Calls func with every connected and unblocked body, without taking a
+    // snapshot. Bodies added while iterating are skipped, and a body that
+    // gets disconnected or blocked before its turn is not called.
+    // func returns false to stop the iteration.
+    template <typename Func>
+    void
+    forEachActive(Func &&func)
+    {
+        Storage *walked = nullptr;
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+
+            walked = this->storage;
+            ++walked->refs;
+        }
+
+        // Leaves the iteration even if a callback throws
+        struct IterationGuard {
+            CallbackBodyList *list;
+            Storage *walked;
+
+            ~IterationGuard()
+            {
+                this->list->finishIteration(this->walked);
+            }
+        } guard{this, walked};
+
+        // Nobody changes the storage while we hold a reference to it
+        for (const auto &entry : walked->bodies) {
+            auto *body = entry.get();
+
+            if (!body->isConnected() || body->isBlocked()) {
+                continue;
+            }
+
+            if (!func(*body)) {
+                break;
+            }
+        }
+    }
+
+    // Drops disconnected bodies and gives unused storage back
+    void
+    compact()
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        if (this->storage->refs > 1) {
+            this->replaceStorageLocked(0);
+        } else {
+            this->sweepLocked();
+        }
+
+        shrinkToFit(this->storage->bodies);
+    }
+
+    // Listener counts and the bytes used by the storage and the bodies
+    [[nodiscard]] MemoryUsage
+    getMemoryUsage() const
+    {
+        MemoryUsage usage;
+
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        const auto &bodies = this->storage->bodies;
+
+        for (const auto &body : bodies) {
+            if (body->isConnected()) {
+                ++usage.liveListeners;
+            } else {
+                ++usage.deadListeners;
+            }
+            usage.estimatedBytes += body->getAllocationSize();
+        }
+        usage.estimatedBytes += bodies.capacity() * sizeof(BodyPtr<BodyType>);
+        usage.capacity = bodies.capacity();
+
+        return usage;
+    }
+
+    [[nodiscard]] bool
+    isEmpty() const
+    {
+        return this->tracker.getCount() == 0;
+    }
+
+    ListenerTracker &
+    getTracker()
+    {
+        return this->tracker;
+    }
+
+    const ListenerTracker &
+    getTracker() const
+    {
+        return this->tracker;
+    }
+
+private:
+    // Bodies sorted by priority, shared by the list and the iterations
+    // walking them. Both fields are guarded by the list's mutex, and the
+    // bodies are only changed while the list is the only user (refs == 1).
+    struct Storage {
+        std::vector<BodyPtr<BodyType>> bodies;
+        std::size_t refs{0};
+    };
+
+    ListenerTracker tracker;
+
+    mutable std::mutex mutex;
+
+    // The first storage lives inside the list, and is reused once the
+    // iterations walking it are done, so only connecting or sweeping while
+    // several iterations overlap allocates a storage
+    Storage inlineStorage{{}, 1};
+    Storage *storage{&inlineStorage};
+
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+    // Bodies we're holding on to, disconnected or not, for LeakDetector
+    static std::size_t
+    countStored(const void *self)
+    {
+        const auto *list = static_cast<const CallbackBodyList *>(self);
+
+        std::unique_lock<std::mutex> lock(list->mutex);
+
+        return list->storage->bodies.size();
+    }
+#endif
+
+    static void
+    insertSorted(std::vector<BodyPtr<BodyType>> &bodies,
+                 BodyPtr<BodyType> &&body)
+    {
+        auto priority = body->getPriority();
+
+        if (bodies.empty() || bodies.back()->getPriority() >= priority) {
+            bodies.emplace_back(std::move(body));
+            return;
+        }
+
+        auto position = std::upper_bound(
+            bodies.begin(), bodies.end(), priority,
+            [](int newPriority, const auto &existing) {
+                return newPriority > existing->getPriority();
+            });
+        bodies.emplace(position, std::move(body));
+    }
+
+    void
+    finishIteration(Storage *walked)
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        if (walked != this->storage) {
+            // Replaced while we were walking it
+            this->releaseLocked(walked);
+            return;
+        }
+
+        if (--walked->refs == 1) {
+            this->sweepLocked();
+            return;
+        }
+
+        // Other iterations are still walking it, sweep into a fresh storage
+        // instead of waiting for a moment when nobody is invoking
+        auto hasDisconnected = std::any_of(
+            walked->bodies.begin(), walked->bodies.end(), [](const auto &body) {
+                return !body->isConnected();
+            });
+        if (hasDisconnected) {
+            this->replaceStorageLocked(0);
+        }
+    }
+
+    // Moves the connected bodies into a storage nobody walks, with room for
+    // extra more, and makes it the current one
+    Storage *
+    replaceStorageLocked(std::size_t extra)
+    {
+        auto *next = this->inlineStorage.refs == 0 ? &this->inlineStorage
+                                                   : new Storage;
+
+        auto &bodies = this->storage->bodies;
+        auto connected = static_cast<std::size_t>(
+            std::count_if(bodies.begin(), bodies.end(), [](const auto &body) {
+                return body->isConnected();
+            }));
+        next->bodies.reserve(connected + extra);
+
+        for (const auto &body : bodies) {
+            if (body->isConnected()) {
+                next->bodies.emplace_back(body);
+            } else {
+                // Already counted as disconnected, by its group or when it
+                // lost its last subscriber
+                body->expire();
+            }
+        }
+        next->refs = 1;
+
+        this->releaseLocked(this->storage);
+        this->storage = next;
+
+        return next;
+    }
+
+    void
+    releaseLocked(Storage *released)
+    {
+        if (--released->refs != 0) {
+            return;
+        }
+
+        if (released == &this->inlineStorage) {
+            // Keeps its capacity for the next time it's used
+            released->bodies.clear();
+        } else {
+            delete released;
+        }
+    }
+
+    void
+    sweepLocked()
+    {
+        auto &bodies = this->storage->bodies;
+
+        auto kept = std::remove_if(
+            bodies.begin(), bodies.end(), [](const auto &body) {
+                if (body->isConnected()) {
+                    return false;
+                }
+
+                // Already counted as disconnected, by its group or when it
+                // lost its last subscriber
+                body->expire();
+                return true;
+            });
+        bodies.erase(kept, bodies.end());
+    }
+};
+
+/// One listener's task of an asynchronous invoke, see Signal::invokeAsync
+// Owns its share of the invoke's countdown: calling the task or destroying it
+// without calling it both finish it, so an executor that drops the task or
+// throws while queueing it can't keep the invoke from completing.
+// A copy is a task of its own, that has to be called or destroyed as well.
+template <typename... Args>
+class AsyncInvokeTask
+{
+    using State = AsyncInvokeState<Args...>;
+    using Body = CallbackBody<Args...>;
+
+public:
+    // Takes over the task the caller added to state
+    AsyncInvokeTask(State *_state, BodyPtr<Body> &&_body)
+        : state(_state)
+        , body(std::move(_body))
+    {
+    }
+
+    AsyncInvokeTask(const AsyncInvokeTask &other)
+        : state(other.state)
+        , body(other.body)
+    {
+        if (this->state != nullptr) {
+            this->state->addTask();
+        }
+    }
+
+    AsyncInvokeTask(AsyncInvokeTask &&other) noexcept
+        : state(std::exchange(other.state, nullptr))
+        , body(std::move(other.body))
+    {
+    }
+
+    AsyncInvokeTask &operator=(const AsyncInvokeTask &other) = delete;
+    AsyncInvokeTask &operator=(AsyncInvokeTask &&other) = delete;
+
+    ~AsyncInvokeTask()
+    {
+        if (this->state != nullptr) {
+            this->state->finishTask();
+        }
+    }
+
+    void
+    operator()()
+    {
+        if (this->state == nullptr) {
+            // Already called
+            return;
+        }
+
+        // Counts down even if the listener throws
+        struct TaskGuard {
+            State *state;
+
+            ~TaskGuard()
+            {
+                this->state->finishTask();
+            }
+        } guard{std::exchange(this->state, nullptr)};
+
+        if (!this->body->isConnected() || this->body->isBlocked()) {
+            return;
+        }
+
+        std::apply(
+            [this](auto &...arguments) {
+                this->body->invoke(arguments...);
+            },
+            guard.state->arguments);
+    }
+
+private:
+    State *state;
+    BodyPtr<Body> body;
+};
+
+}  // namespace detail
+
+/// How Signal::invoke walks its listeners
+// Both strategies call listeners connected during an invoke from the next
+// invoke on. They differ in listeners that get disconnected or blocked while
+// an invoke is running, i.e. by an earlier listener.
+enum class EmitStrategy {
+    // Copy the active listeners into a temporary list before calling them
+    // Every listener in the list is called, even if it got disconnected or
+    // blocked before its turn
+    Snapshot,
+
+    // Call the listeners straight from the listener storage
+    // A listener that got disconnected or blocked before its turn is skipped.
+    // Connecting while an invoke runs copies the listener storage once, so
+    // the running invoke keeps walking the listeners it started with
+    InPlace,
+};
+
+/// What Signal::invoke does when a listener throws
+// Listeners whose callback is noexcept are never wrapped in a try block, so
+// they cost the same under every policy.
+// Without exception support (i.e. -fno-exceptions) listeners can't throw and
+// every policy behaves the same.
+enum class ExceptionPolicy {
+    // The exception leaves invoke right away, remaining listeners are skipped
+    Propagate,
+
+    // Remaining listeners are still called, then the first exception is
+    // rethrown
+    RethrowFirst,
+
+    // Every exception is handed to the exception handler and invoke doesn't
+    // throw. Exceptions are dropped if there is no handler.
+    Report,
+};
+
 template <typename... Args>
 class Signal
 {
 public:
     using CallbackBodyType = detail::CallbackBody<Args...>;
 
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+    // site is where the signal was created, reported by
+    // LeakDetector::checkGrowth
+    Signal(CallSite site = CallSite::current())
+        : callbackBodies(site)
+    {
+    }
+#else
+    Signal() = default;
+#endif
+
+    Signal(const Signal &other) = delete;
+    Signal &operator=(const Signal &other) = delete;
+
+    // Listeners with a higher priority are called first, listeners with the
+    // same priority are called in the order they were connected
+    // A listener returning Propagation::Stop skips all remaining listeners
+    // site is what LeakDetector files the listener under, the caller's
+    // location unless a CallSite::tagged is passed
+    template <typename Callback>
+    [[nodiscard]] Connection
+    connect(Callback &&func, int priority = 0,
+            CallSite site = CallSite::current())
+    {
+        using Func = std::decay_t<Callback>;
+
+        static_assert(std::is_invocable_v<Func &, Args...>,
+                      "Callback must be callable with the signal's arguments");
+
+        return this->callbackBodies.add(
+            detail::makeBody<detail::FunctionCallbackBody<Func, Args...>>(
+                std::forward<Callback>(func)),
+            priority, site);
+    }
+
+    // Connect a member function of object without wrapping it in a std::function
+    // Usage: signal.connect<&Foo::onBar>(foo)
+    template <auto Method, typename T>
     [[nodiscard]] Connection
-    connect(typename CallbackBodyType::FunctionSignature func)
+    connect(T *object, int priority = 0, CallSite site = CallSite::current())
     {
-        auto callback = std::make_shared<CallbackBodyType>();
-        callback->func = std::move(func);
+        static_assert(std::is_member_function_pointer_v<decltype(Method)>,
+                      "Method must be a member function pointer");
+        static_assert(std::is_invocable_v<decltype(Method), T *, Args...>,
+                      "Method must be callable with the signal's arguments");
 
-        std::weak_ptr<CallbackBodyType> weakCallback(callback);
+        return this->callbackBodies.add(
+            detail::makeBody<detail::MemberCallbackBody<Method, T, Args...>>(
+                object),
+            priority, site);
+    }
 
-        this->registerBody(std::move(callback));
+    // Same as above, but the object's lifetime is tracked so the callback
+    // is skipped once the object has been destroyed
+    template <auto Method, typename T>
+    [[nodiscard]] Connection
+    connect(const std::shared_ptr<T> &object, int priority = 0,
+            CallSite site = CallSite::current())
+    {
+        static_assert(std::is_member_function_pointer_v<decltype(Method)>,
+                      "Method must be a member function pointer");
+        static_assert(std::is_invocable_v<decltype(Method), T *, Args...>,
+                      "Method must be callable with the signal's arguments");
 
-        return Connection(weakCallback);
+        return this->callbackBodies.add(
+            detail::makeBody<
+                detail::TrackedMemberCallbackBody<Method, T, Args...>>(
+                object),
+            priority, site);
     }
 
     void
     invoke(Args... args)
     {
-        auto activeBodies = this->getActiveBodies();
+        if (this->blockCount.load(std::memory_order_acquire) != 0) {
+            if (this->suppressIfBlocked(args...)) {
+                return;
+            }
+        }
+
+        if (this->callbackBodies.isEmpty()) {
+            // Nobody is listening, don't bother collecting bodies
+            return;
+        }
+
+#if PAJLADA_SIGNALS_EXCEPTIONS
+        if (this->exceptions &&
+            this->exceptions->policy != ExceptionPolicy::Propagate) {
+            this->invokeGuarded(args...);
+            return;
+        }
+#endif
+
+        if (this->emitStrategy == EmitStrategy::InPlace) {
+            this->callbackBodies.forEachActive([&](CallbackBodyType &cb) {
+                return cb.invoke(args...) != Propagation::Stop;
+            });
+            return;
+        }
+
+        auto activeBodies = this->callbackBodies.getActiveBodies();
 
         for (const auto &cb : activeBodies) {
-            cb->func(args...);
+            if (cb->invoke(args...) == Propagation::Stop) {
+                break;
+            }
         }
     }
 
-private:
-    std::mutex callbackBodiesMutex;
-    std::vector<std::shared_ptr<CallbackBodyType>> callbackBodies;
+    // Hands each active listener to executor instead of calling it, i.e. to
+    // run it on a thread pool or another thread's event loop
+    // executor is called with a task taking no arguments, and should call
+    // that task once, from any thread. The returned handle completes once
+    // every task has been called or destroyed, a task that's destroyed
+    // without being called skips its listener.
+    // The arguments are copied once and shared by all tasks, so an invoke
+    // costs a single allocation no matter how many listeners there are.
+    // A task is two pointers, an executor queueing them in MoveOnlyFunction
+    // doesn't allocate either.
+    // Listeners disconnected or blocked before their task runs are skipped.
+    // Tasks may run in any order, so Propagation::Stop has no effect.
+    // Usage:
+    //   auto done = signal.invokeAsync(
+    //       [&pool](auto task) { pool.post(std::move(task)); }, buffer);
+    //   done.then([&] { bufferPool.release(buffer); });
+    template <typename Executor>
+    [[nodiscard]] InvokeCompletion
+    invokeAsync(Executor &&executor, Args... args)
+    {
+        if (this->blockCount.load(std::memory_order_acquire) != 0) {
+            if (this->suppressIfBlocked(args...)) {
+                return {};
+            }
+        }
 
-    std::vector<std::shared_ptr<CallbackBodyType>>
-    getActiveBodies()
+        if (this->callbackBodies.isEmpty()) {
+            return {};
+        }
+
+        using State = detail::AsyncInvokeState<Args...>;
+
+        auto *state = new State(std::forward<Args>(args)...);
+        InvokeCompletion completion(state);
+
+        // Finishes the emitter's own task even if a listener run inline throws
+        struct EmitterGuard {
+            State *state;
+
+            ~EmitterGuard()
+            {
+                this->state->finishTask();
+            }
+        } guard{state};
+
+        this->callbackBodies.forEachActive([&](CallbackBodyType &cb) {
+            cb.retain();
+            detail::BodyPtr<CallbackBodyType> body(&cb);
+
+            state->addTask();
+            executor(detail::AsyncInvokeTask<Args...>(state, std::move(body)));
+
+            return true;
+        });
+
+        return completion;
+    }
+
+    // Must be set before the signal is shared between threads
+    void
+    setEmitStrategy(EmitStrategy strategy)
     {
-        std::vector<std::shared_ptr<CallbackBodyType>> activeBodies;
+        this->emitStrategy = strategy;
+    }
 
-        std::unique_lock<std::mutex> lock(this->callbackBodiesMutex);
+    [[nodiscard]] EmitStrategy
+    getEmitStrategy() const
+    {
+        return this->emitStrategy;
+    }
 
-        for (auto it = this->callbackBodies.begin();
-             it != this->callbackBodies.end();) {
-            auto &callback = *it;
+    // Must be set before the signal is shared between threads
+    void
+    setExceptionPolicy(ExceptionPolicy policy)
+    {
+        this->getExceptionState().policy = policy;
+    }
 
-            if (!callback->isConnected()) {
-                // Clean up disconnected callbacks
-                it = this->callbackBodies.erase(it);
-                continue;
+    [[nodiscard]] ExceptionPolicy
+    getExceptionPolicy() const
+    {
+        if (!this->exceptions) {
+            return ExceptionPolicy::Propagate;
+        }
+
+        return this->exceptions->policy;
+    }
+
+    // Receives the exceptions of ExceptionPolicy::Report, on the thread that
+    // invoked the signal
+    // Must be set before the signal is shared between threads
+    void
+    setExceptionHandler(std::function<void(std::exception_ptr)> handler)
+    {
+        this->getExceptionState().handler = std::move(handler);
+    }
+
+    // Suppresses delivery to all listeners until unblocked
+    // Blocks nest, the signal stays blocked until every block has been undone
+    // Returns true if the signal went from unblocked to blocked
+    bool
+    block()
+    {
+        return this->blockCount.fetch_add(1, std::memory_order_acq_rel) == 0;
+    }
+
+    // Returns true if the signal went from blocked to unblocked
+    bool
+    unblock()
+    {
+        if (this->replay) {
+            std::optional<std::tuple<std::decay_t<Args>...>> suppressed;
+
+            {
+                std::unique_lock<std::mutex> lock(this->replay->mutex);
+
+                if (!this->decrementBlockCount()) {
+                    return false;
+                }
+
+                suppressed.swap(this->replay->lastSuppressed);
             }
 
-            if (!callback->isBlocked()) {
-                activeBodies.emplace_back(callback);
+            if (suppressed) {
+                std::apply(
+                    [this](auto &...args) {
+                        this->invoke(std::forward<Args>(args)...);
+                    },
+                    *suppressed);
             }
 
-            ++it;
+            return true;
         }
 
-        return activeBodies;
+        return this->decrementBlockCount();
     }
 
+    [[nodiscard]] bool
+    isBlocked() const
+    {
+        return this->blockCount.load(std::memory_order_acquire) != 0;
+    }
+
+    // When enabled, the last invoke suppressed while blocked is delivered
+    // once the signal is unblocked again
+    // Must be set up before the signal is shared between threads
+    void
+    setReplayOnUnblock(bool enabled)
+    {
+        if (enabled && !this->replay) {
+            this->replay = std::make_unique<ReplayState>();
+        } else if (!enabled) {
+            this->replay.reset();
+        }
+    }
+
+    // Called when the number of connected listeners goes from 0 to 1
+    // Useful for starting a producer only once someone is listening
+    void
+    onFirstConnect(std::function<void()> hook)
+    {
+        this->callbackBodies.getTracker().setOnFirstConnect(std::move(hook));
+    }
+
+    // Called when the number of connected listeners goes from 1 to 0
+    void
+    onLastDisconnect(std::function<void()> hook)
+    {
+        this->callbackBodies.getTracker().setOnLastDisconnect(std::move(hook));
+    }
+
+    // Number of connected listeners, including blocked ones
+    [[nodiscard]] std::size_t
+    getListenerCount() const
+    {
+        return this->callbackBodies.getTracker().getCount();
+    }
+
+    [[nodiscard]] MemoryUsage
+    getMemoryUsage() const
+    {
+        auto usage = this->callbackBodies.getMemoryUsage();
+        usage.estimatedBytes += sizeof(*this);
+        if (this->replay) {
+            usage.estimatedBytes += sizeof(ReplayState);
+        }
+        if (this->exceptions) {
+            usage.estimatedBytes += sizeof(ExceptionState);
+        }
+
+        return usage;
+    }
+
+    // Drops disconnected listeners and gives unused storage back, i.e.
+    // after disconnecting a large number of listeners
     void
-    registerBody(std::shared_ptr<CallbackBodyType> &&body)
+    compact()
+    {
+        this->callbackBodies.compact();
+    }
+
+private:
+    struct ReplayState {
+        std::mutex mutex;
+        std::optional<std::tuple<std::decay_t<Args>...>> lastSuppressed;
+    };
+
+    struct ExceptionState {
+        ExceptionPolicy policy{ExceptionPolicy::Propagate};
+        std::function<void(std::exception_ptr)> handler;
+    };
+
+    detail::CallbackBodyList<CallbackBodyType> callbackBodies;
+    EmitStrategy emitStrategy{EmitStrategy::Snapshot};
+
+    std::atomic<uint32_t> blockCount{0};
+    std::unique_ptr<ReplayState> replay;
+
+    // Only allocated once a policy or handler is set, invoke doesn't look any
+    // further while it's empty
+    std::unique_ptr<ExceptionState> exceptions;
+
+    ExceptionState &
+    getExceptionState()
+    {
+        if (!this->exceptions) {
+            this->exceptions = std::make_unique<ExceptionState>();
+        }
+
+        return *this->exceptions;
+    }
+
+#if PAJLADA_SIGNALS_EXCEPTIONS
+    // Same as invoke, but applies the exception policy
+    void
+    invokeGuarded(Args &...args)
+    {
+        std::exception_ptr firstException;
+
+        auto invokeOne = [&](CallbackBodyType &cb) {
+            if (!cb.mayThrow()) {
+                return cb.invoke(args...) != Propagation::Stop;
+            }
+
+            return this->invokeCatching(cb, firstException, args...) !=
+                   Propagation::Stop;
+        };
+
+        if (this->emitStrategy == EmitStrategy::InPlace) {
+            this->callbackBodies.forEachActive(invokeOne);
+        } else {
+            auto activeBodies = this->callbackBodies.getActiveBodies();
+
+            for (const auto &cb : activeBodies) {
+                if (!invokeOne(*cb)) {
+                    break;
+                }
+            }
+        }
+
+        if (firstException) {
+            std::rethrow_exception(firstException);
+        }
+    }
+
+    // Kept out of invokeGuarded so listeners that can't throw don't share
+    // its try block
+    Propagation
+    invokeCatching(CallbackBodyType &cb, std::exception_ptr &firstException,
+                   Args &...args)
     {
-        std::unique_lock<std::mutex> lock(this->callbackBodiesMutex);
+        try {
+            return cb.invoke(args...);
+        } catch (...) {
+            if (this->exceptions->policy == ExceptionPolicy::RethrowFirst) {
+                if (!firstException) {
+                    firstException = std::current_exception();
+                }
+            } else if (this->exceptions->handler) {
+                this->exceptions->handler(std::current_exception());
+            }
+        }
 
-        this->callbackBodies.emplace_back(std::move(body));
+        return Propagation::Continue;
+    }
+#endif
+
+    // Returns false if the signal got unblocked in the meantime
+    bool
+    suppressIfBlocked(Args &...args)
+    {
+        if (!this->replay) {
+            return true;
+        }
+
+        std::unique_lock<std::mutex> lock(this->replay->mutex);
+
+        if (this->blockCount.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+
+        this->replay->lastSuppressed.emplace(std::forward<Args>(args)...);
+
+        return true;
+    }
+
+    bool
+    decrementBlockCount()
+    {
+        auto current = this->blockCount.load(std::memory_order_acquire);
+        do {
+            if (current == 0) {
+                return false;
+            }
+        } while (!this->blockCount.compare_exchange_weak(
+            current, current - 1, std::memory_order_acq_rel,
+            std::memory_order_acquire));
+
+        return current == 1;
     }
 };
 
 using NoArgSignal = Signal<>;
 
+/// Result-collecting Signals
+// Every listener returns an R. collect hands the results to a combiner
+// (see combiners.hpp), which can stop calling the remaining listeners once it
+// knows its answer.
+// A combiner needs a `bool add(R &&value)` that returns false to stop, and a
+// `result()` that collect returns.
+template <typename R, typename... Args>
+class Signal<R(Args...)>
+{
+    static_assert(!std::is_void_v<R>,
+                  "Use Signal<Args...> for listeners without a result");
+
+public:
+    using CallbackBodyType = detail::ResultCallbackBody<R, Args...>;
+
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+    Signal(CallSite site = CallSite::current())
+        : callbackBodies(site)
+    {
+    }
+#else
+    Signal() = default;
+#endif
+
+    Signal(const Signal &other) = delete;
+    Signal &operator=(const Signal &other) = delete;
+
+    template <typename Callback>
+    [[nodiscard]] Connection
+    connect(Callback &&func, int priority = 0,
+            CallSite site = CallSite::current())
+    {
+        using Func = std::decay_t<Callback>;
+
+        static_assert(std::is_invocable_r_v<R, Func &, Args...>,
+                      "Callback must be callable with the signal's arguments "
+                      "and return the signal's result type");
+
+        return this->callbackBodies.add(
+            detail::makeBody<
+                detail::FunctionResultCallbackBody<Func, R, Args...>>(
+                std::forward<Callback>(func)),
+            priority, site);
+    }
+
+    // Usage: signal.connect<&Foo::canClose>(foo)
+    template <auto Method, typename T>
+    [[nodiscard]] Connection
+    connect(T *object, int priority = 0, CallSite site = CallSite::current())
+    {
+        static_assert(std::is_invocable_r_v<R, decltype(Method), T *, Args...>,
+                      "Method must be callable with the signal's arguments "
+                      "and return the signal's result type");
+
+        return this->callbackBodies.add(
+            detail::makeBody<
+                detail::MemberResultCallbackBody<Method, T, R, Args...>>(
+                object),
+            priority, site);
+    }
+
+    // Calls every listener and discards their results
+    void
+    invoke(Args... args)
+    {
+        if (this->callbackBodies.isEmpty()) {
+            return;
+        }
+
+        auto activeBodies = this->callbackBodies.getActiveBodies();
+
+        for (const auto &cb : activeBodies) {
+            cb->invoke(args...);
+        }
+    }
+
+    // Usage: bool vetoed = signal.collect(combiners::AnyTrue{}, window);
+    template <typename Combiner>
+    decltype(auto)
+    collect(Combiner &&combiner, Args... args)
+    {
+        if (!this->callbackBodies.isEmpty()) {
+            auto activeBodies = this->callbackBodies.getActiveBodies();
+
+            for (const auto &cb : activeBodies) {
+                if (!combiner.add(cb->invoke(args...))) {
+                    break;
+                }
+            }
+        }
+
+        return std::forward<Combiner>(combiner).result();
+    }
+
+    // Number of connected listeners, including blocked ones
+    [[nodiscard]] std::size_t
+    getListenerCount() const
+    {
+        return this->callbackBodies.getTracker().getCount();
+    }
+
+    [[nodiscard]] MemoryUsage
+    getMemoryUsage() const
+    {
+        auto usage = this->callbackBodies.getMemoryUsage();
+        usage.estimatedBytes += sizeof(*this);
+
+        return usage;
+    }
+
+    // Drops disconnected listeners and gives unused storage back
+    void
+    compact()
+    {
+        this->callbackBodies.compact();
+    }
+
+private:
+    detail::CallbackBodyList<CallbackBodyType> callbackBodies;
+};
+
 /// Bolt Signals (1-time use)
 // connect is fast
 // disconnect doesn't exist
@@ -90,7 +1086,7 @@ template <class... Args>
 class BoltSignal
 {
 protected:
-    typedef std::function<void(Args...)> CallbackType;
+    typedef MoveOnlyFunction<void(Args...)> CallbackType;
 
 public:
     void
@@ -102,11 +1098,13 @@ public:
     void
     invoke(Args... args)
     {
-        for (auto &callback : this->callbacks) {
+        // Callbacks connected while invoking are kept for the next invoke
+        auto firing = std::move(this->callbacks);
+        this->callbacks.clear();
+
+        for (auto &callback : firing) {
             callback(args...);
         }
-
-        this->callbacks.clear();
     }
 
 protected:
@@ -116,31 +1114,88 @@ protected:
 using NoArgBoltSignal = BoltSignal<>;
 
 /// Disconnects callback when callback is true
+// Callbacks can also be disconnected from the outside with the Connection
+// returned by connect
+// Listeners are called in place like with EmitStrategy::InPlace: listeners
+// connected during an invoke are called from the next one on, and a listener
+// disconnected before its turn is skipped. A listener must not destroy the
+// signal it is being called by.
 template <class... Args>
 class SelfDisconnectingSignal
 {
 protected:
-    typedef std::function<bool(Args...)> CallbackType;
+    using CallbackBodyType = detail::SelfDisconnectingCallbackBody<Args...>;
 
 public:
-    void
-    connect(CallbackType cb)
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+    SelfDisconnectingSignal(CallSite site = CallSite::current())
+        : callbackBodies(site)
     {
-        this->callbacks.push_back(std::move(cb));
+    }
+#else
+    SelfDisconnectingSignal() = default;
+#endif
+
+    SelfDisconnectingSignal(const SelfDisconnectingSignal &other) = delete;
+    SelfDisconnectingSignal &operator=(const SelfDisconnectingSignal &other) =
+        delete;
+
+    template <typename Callback>
+    Connection
+    connect(Callback &&func, CallSite site = CallSite::current())
+    {
+        using Func = std::decay_t<Callback>;
+
+        static_assert(std::is_invocable_r_v<bool, Func &, Args...>,
+                      "Callback must return whether it should be disconnected");
+
+        return this->callbackBodies.add(
+            detail::makeBody<
+                detail::FunctionSelfDisconnectingCallbackBody<Func, Args...>>(
+                std::forward<Callback>(func)),
+            0, site);
     }
 
     void
     invoke(Args... args)
     {
-        callbacks.erase(std::remove_if(callbacks.begin(), callbacks.end(),
-                                       [&](CallbackType callback) {
-                                           return callback(args...);
-                                       }),
-                        callbacks.end());
+        if (this->callbackBodies.isEmpty()) {
+            return;
+        }
+
+        this->callbackBodies.forEachActive([&](CallbackBodyType &cb) {
+            if (cb.invoke(args...)) {
+                cb.expire();
+            }
+            return true;
+        });
     }
 
-protected:
-    std::vector<CallbackType> callbacks;
+    // Number of connected listeners, including blocked ones
+    [[nodiscard]] std::size_t
+    getListenerCount() const
+    {
+        return this->callbackBodies.getTracker().getCount();
+    }
+
+    [[nodiscard]] MemoryUsage
+    getMemoryUsage() const
+    {
+        auto usage = this->callbackBodies.getMemoryUsage();
+        usage.estimatedBytes += sizeof(*this);
+
+        return usage;
+    }
+
+    // Drops disconnected listeners and gives unused storage back
+    void
+    compact()
+    {
+        this->callbackBodies.compact();
+    }
+
+private:
+    detail::CallbackBodyList<CallbackBodyType> callbackBodies;
 };
 
 using NoArgSelfDisconnectingSignal = SelfDisconnectingSignal<>;
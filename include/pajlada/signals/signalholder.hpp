@@ -1,16 +1,26 @@
 #pragma once
 
 #include <pajlada/signals/connection.hpp>
+#include <pajlada/signals/memory-usage.hpp>
 #include <pajlada/signals/scoped-connection.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <utility>
 #include <vector>
 
 namespace pajlada {
 namespace Signals {
 
+/// Owns connections and disconnects all of them when cleared or destroyed
+// Connections made through managedConnect join the holder's connection group,
+// so clearing them costs one step per connected signal no matter how many
+// connections there are. The signals' listener counts and hooks are updated
+// right away, the stale bodies are swept by their signals later on.
 class SignalHolder final
 {
     std::vector<ScopedConnection> _managedConnections;
+    detail::ConnectionGroupPtr _group;
 
     void
     add(ScopedConnection &&connection)
@@ -18,12 +28,40 @@ class SignalHolder final
         this->_managedConnections.emplace_back(std::move(connection));
     }
 
+    void
+    addToGroup(Connection &&connection)
+    {
+        // The group keeps the body connected, the connection itself is not needed
+        connection.joinGroup(this->_group.getOrCreate());
+    }
+
 public:
     SignalHolder() = default;
-    ~SignalHolder() = default;
 
-    SignalHolder(SignalHolder &&) = default;
-    SignalHolder &operator=(SignalHolder &&) = default;
+    ~SignalHolder()
+    {
+        this->clear();
+    }
+
+    SignalHolder(SignalHolder &&other) noexcept
+        : _managedConnections(std::move(other._managedConnections))
+        , _group(std::move(other._group))
+    {
+    }
+
+    SignalHolder &
+    operator=(SignalHolder &&other) noexcept
+    {
+        if (&other == this) {
+            return *this;
+        }
+
+        this->clear();
+        this->_managedConnections = std::move(other._managedConnections);
+        this->_group = std::move(other._group);
+        return *this;
+    }
+
     SignalHolder(const SignalHolder &other) = delete;
     SignalHolder &operator=(const SignalHolder &other) = delete;
 
@@ -35,9 +73,21 @@ public:
 
     template <typename Signal, typename Callback>
     void
-    managedConnect(Signal &signal, Callback cb)
+    managedConnect(Signal &signal, Callback cb,
+                   CallSite site = CallSite::current())
+    {
+        this->addToGroup(
+            detail::connectAt(signal, std::forward<Callback>(cb), site));
+    }
+
+    // Connect a member function of object, disconnected when this holder dies
+    // Usage: holder.managedConnect<&Foo::onBar>(signal, this)
+    template <auto Method, typename Signal, typename T>
+    void
+    managedConnect(Signal &signal, T *object,
+                   CallSite site = CallSite::current())
     {
-        this->add(signal.connect(std::forward<Callback>(cb)));
+        this->addToGroup(detail::connectAt<Method>(signal, object, site));
     }
 
     // Clear all connections held by this SignalHolder
@@ -45,6 +95,60 @@ public:
     clear()
     {
         this->_managedConnections.clear();
+
+        if (auto *group = this->_group.get()) {
+            group->invalidate();
+        }
+    }
+
+    // Drops connections that got disconnected elsewhere and gives unused
+    // storage back
+    void
+    compact()
+    {
+        this->_managedConnections.erase(
+            std::remove_if(this->_managedConnections.begin(),
+                           this->_managedConnections.end(),
+                           [](const ScopedConnection &connection) {
+                               return !connection.isConnected();
+                           }),
+            this->_managedConnections.end());
+        detail::shrinkToFit(this->_managedConnections);
+
+        auto *group = this->_group.get();
+        if (group != nullptr && group->getConnectedCount() == 0) {
+            // Only stale bodies still refer to the group
+            this->_group.reset();
+        }
+    }
+
+    // Listeners connected through managedConnect are counted as live while
+    // they're connected, the memory of their bodies is accounted for by their
+    // signals
+    [[nodiscard]] MemoryUsage
+    getMemoryUsage() const
+    {
+        MemoryUsage usage;
+
+        for (const auto &connection : this->_managedConnections) {
+            if (connection.isConnected()) {
+                ++usage.liveListeners;
+            } else {
+                ++usage.deadListeners;
+            }
+        }
+        if (auto *group = this->_group.get()) {
+            usage.liveListeners += group->getConnectedCount();
+        }
+
+        usage.capacity = this->_managedConnections.capacity();
+        usage.estimatedBytes =
+            sizeof(*this) + usage.capacity * sizeof(ScopedConnection);
+        if (this->_group.get() != nullptr) {
+            usage.estimatedBytes += sizeof(detail::ConnectionGroup);
+        }
+
+        return usage;
     }
 };
 
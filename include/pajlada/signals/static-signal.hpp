@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace pajlada {
+namespace Signals {
+
+/// Static Signals (listeners fixed at compile time)
+// for pipelines whose topology never changes
+// connect/disconnect don't exist
+// invoke calls every listener directly in order, without locking or
+// type erasure, so the calls can be inlined
+template <typename Listeners, typename... Args>
+class StaticSignal;
+
+template <typename... Listeners, typename... Args>
+class StaticSignal<std::tuple<Listeners...>, Args...>
+{
+    static_assert((std::is_invocable_v<Listeners &, Args &...> && ...),
+                  "Every listener must be callable with the signal's "
+                  "arguments");
+
+public:
+    explicit StaticSignal(Listeners... _listeners)
+        : listeners(std::move(_listeners)...)
+    {
+    }
+
+    void
+    invoke(Args... args)
+    {
+        std::apply(
+            [&](auto &...listener) {
+                (listener(args...), ...);
+            },
+            this->listeners);
+    }
+
+    [[nodiscard]] static constexpr std::size_t
+    getListenerCount()
+    {
+        return sizeof...(Listeners);
+    }
+
+private:
+    std::tuple<Listeners...> listeners;
+};
+
+// Usage: auto signal = makeStaticSignal<int>(consumerA, consumerB);
+template <typename... Args, typename... Listeners>
+StaticSignal<std::tuple<std::decay_t<Listeners>...>, Args...>
+makeStaticSignal(Listeners &&...listeners)
+{
+    return StaticSignal<std::tuple<std::decay_t<Listeners>...>, Args...>(
+        std::forward<Listeners>(listeners)...);
+}
+
+}  // namespace Signals
+}  // namespace pajlada
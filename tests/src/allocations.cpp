@@ -0,0 +1,476 @@
+#include <pajlada/signals/operators.hpp>
+#include <pajlada/signals/scoped-connection.hpp>
+#include <pajlada/signals/signal.hpp>
+#include <pajlada/signals/signalholder.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+// These tests document what each operation costs in heap allocations.
+// If one of them fails after a change, the change added an allocation to a
+// hot path - update the expected number only if that's intended.
+
+namespace {
+
+// Only allocations made by the thread that opened an AllocationCounter are
+// counted, so gtest and other threads don't get in the way
+thread_local std::size_t *activeAllocationCount = nullptr;
+
+[[noreturn]] void
+outOfMemory()
+{
+#if PAJLADA_SIGNALS_EXCEPTIONS
+    throw std::bad_alloc();
+#else
+    std::abort();
+#endif
+}
+
+// std::aligned_alloc doesn't exist on MSVC, and its aligned blocks must be
+// freed with _aligned_free
+void *
+alignedAllocate(std::size_t size, std::size_t align)
+{
+#if defined(_MSC_VER)
+    return _aligned_malloc(size == 0 ? align : size, align);
+#else
+    auto rounded = (size + align - 1) / align * align;
+    return std::aligned_alloc(align, rounded == 0 ? align : rounded);
+#endif
+}
+
+void
+alignedFree(void *ptr)
+{
+#if defined(_MSC_VER)
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+void
+countAllocation()
+{
+    if (activeAllocationCount != nullptr) {
+        ++*activeAllocationCount;
+    }
+}
+
+class AllocationCounter
+{
+public:
+    AllocationCounter()
+    {
+        activeAllocationCount = &this->count;
+    }
+
+    ~AllocationCounter()
+    {
+        activeAllocationCount = nullptr;
+    }
+
+    AllocationCounter(const AllocationCounter &other) = delete;
+    AllocationCounter &operator=(const AllocationCounter &other) = delete;
+
+    [[nodiscard]] std::size_t
+    get() const
+    {
+        return this->count;
+    }
+
+private:
+    std::size_t count{0};
+};
+
+// Counts the allocations made while running func
+template <typename Func>
+std::size_t
+countAllocations(Func &&func)
+{
+    AllocationCounter counter;
+    func();
+    return counter.get();
+}
+
+// Gives the signal's listener storage room for count listeners, so
+// connecting doesn't have to grow it
+// The disconnected listeners are swept by the next connect
+template <typename SignalType>
+void
+reserveListeners(SignalType &signal, std::size_t count)
+{
+    std::vector<pajlada::Signals::Connection> connections;
+    for (std::size_t i = 0; i < count; ++i) {
+        connections.emplace_back(signal.connect([](int) {}));
+    }
+    for (auto &connection : connections) {
+        connection.disconnect();
+    }
+}
+
+}  // namespace
+
+// The nothrow forms end up in these by default. The array and sized forms
+// are replaced as well, since sanitizers provide their own versions of them.
+void *
+operator new(std::size_t size)
+{
+    countAllocation();
+
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+
+    outOfMemory();
+}
+
+void *
+operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void
+operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete(void *ptr, std::size_t /*size*/) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete[](void *ptr, std::size_t /*size*/) noexcept
+{
+    std::free(ptr);
+}
+
+void *
+operator new(std::size_t size, std::align_val_t alignment)
+{
+    countAllocation();
+
+    if (void *ptr =
+            alignedAllocate(size, static_cast<std::size_t>(alignment))) {
+        return ptr;
+    }
+
+    outOfMemory();
+}
+
+void *
+operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void
+operator delete(void *ptr, std::align_val_t /*alignment*/) noexcept
+{
+    alignedFree(ptr);
+}
+
+void
+operator delete[](void *ptr, std::align_val_t /*alignment*/) noexcept
+{
+    alignedFree(ptr);
+}
+
+void
+operator delete(void *ptr, std::size_t /*size*/,
+                std::align_val_t /*alignment*/) noexcept
+{
+    alignedFree(ptr);
+}
+
+void
+operator delete[](void *ptr, std::size_t /*size*/,
+                  std::align_val_t /*alignment*/) noexcept
+{
+    alignedFree(ptr);
+}
+
+using namespace pajlada::Signals;
+
+TEST(Allocations, CounterSeesAllocations)
+{
+    // Stored in a volatile so the compiler can't elide the allocation
+    static int *volatile value = nullptr;
+
+    auto allocations = countAllocations([] {
+        value = new int(5);
+        delete value;
+    });
+
+    EXPECT_EQ(allocations, 1);
+}
+
+TEST(Allocations, InvokeWithoutListeners)
+{
+    Signal<int> signal;
+
+    EXPECT_EQ(countAllocations([&] {
+                  signal.invoke(1);
+              }),
+              0);
+}
+
+TEST(Allocations, InvokeSnapshot)
+{
+    for (std::size_t listenerCount : {1, 8, 100}) {
+        Signal<int> signal;
+
+        int sum = 0;
+        std::vector<Connection> connections;
+        for (std::size_t i = 0; i < listenerCount; ++i) {
+            connections.emplace_back(signal.connect([&sum](int value) {
+                sum += value;
+            }));
+        }
+
+        // A single allocation for the snapshot, no matter how many listeners
+        EXPECT_EQ(countAllocations([&] {
+                      signal.invoke(1);
+                  }),
+                  1)
+            << "with " << listenerCount << " listeners";
+        EXPECT_EQ(sum, listenerCount);
+    }
+}
+
+TEST(Allocations, InvokeInPlace)
+{
+    for (std::size_t listenerCount : {1, 8, 100}) {
+        Signal<int> signal;
+        signal.setEmitStrategy(EmitStrategy::InPlace);
+
+        int sum = 0;
+        std::vector<Connection> connections;
+        for (std::size_t i = 0; i < listenerCount; ++i) {
+            connections.emplace_back(signal.connect([&sum](int value) {
+                sum += value;
+            }));
+        }
+
+        EXPECT_EQ(countAllocations([&] {
+                      signal.invoke(1);
+                  }),
+                  0)
+            << "with " << listenerCount << " listeners";
+        EXPECT_EQ(sum, listenerCount);
+    }
+}
+
+TEST(Allocations, InvokeAsync)
+{
+    for (std::size_t listenerCount : {1, 8, 100}) {
+        Signal<int> signal;
+
+        int sum = 0;
+        std::vector<Connection> connections;
+        for (std::size_t i = 0; i < listenerCount; ++i) {
+            connections.emplace_back(signal.connect([&sum](int value) {
+                sum += value;
+            }));
+        }
+
+        std::vector<MoveOnlyFunction<void()>> tasks;
+        tasks.reserve(listenerCount);
+
+        // A single allocation for the shared state, no matter how many
+        // listeners. The tasks fit in MoveOnlyFunction's inline storage.
+        EXPECT_EQ(countAllocations([&] {
+                      auto completion = signal.invokeAsync(
+                          [&tasks](auto task) {
+                              tasks.emplace_back(std::move(task));
+                          },
+                          1);
+
+                      for (auto &task : tasks) {
+                          task();
+                      }
+                      tasks.clear();
+
+                      EXPECT_TRUE(completion.isDone());
+                  }),
+                  1)
+            << "with " << listenerCount << " listeners";
+        EXPECT_EQ(sum, listenerCount);
+    }
+}
+
+TEST(Allocations, Connect)
+{
+    if (PAJLADA_SIGNALS_LEAK_DETECTOR) {
+        GTEST_SKIP()
+            << "The leak detector allocates a string key on every connect";
+    }
+
+    Signal<int> signal;
+    reserveListeners(signal, 4);
+
+    // The callback body and its control block share one allocation
+    Connection conn;
+    EXPECT_EQ(countAllocations([&] {
+                  conn = signal.connect([](int) {});
+              }),
+              1);
+
+    // Member functions don't need a std::function either
+    struct Listener {
+        void
+        onValue(int /*value*/)
+        {
+        }
+    } listener;
+    Connection memberConn;
+    EXPECT_EQ(countAllocations([&] {
+                  memberConn = signal.connect<&Listener::onValue>(&listener);
+              }),
+              1);
+}
+
+TEST(Allocations, Disconnect)
+{
+    Signal<int> signal;
+    signal.setEmitStrategy(EmitStrategy::InPlace);
+    auto conn = signal.connect([](int) {});
+
+    // Keeps invoke from returning early, so it sweeps
+    auto other = signal.connect([](int) {});
+
+    EXPECT_EQ(countAllocations([&] {
+                  EXPECT_TRUE(conn.disconnect());
+              }),
+              0);
+
+    // Sweeping the disconnected body after an in-place invoke only frees
+    // memory
+    EXPECT_EQ(countAllocations([&] {
+                  signal.invoke(1);
+              }),
+              0);
+    EXPECT_EQ(signal.getMemoryUsage().deadListeners, 0);
+}
+
+TEST(Allocations, ConnectionCopy)
+{
+    Signal<int> signal;
+    auto conn = signal.connect([](int) {});
+
+    EXPECT_EQ(countAllocations([&] {
+                  Connection copy(conn);
+                  Connection assigned;
+                  assigned = copy;
+              }),
+              0);
+
+    conn.disconnect();
+}
+
+TEST(Allocations, ScopedConnectionMove)
+{
+    Signal<int> signal;
+    ScopedConnection first(signal.connect([](int) {}));
+
+    EXPECT_EQ(countAllocations([&] {
+                  ScopedConnection second(std::move(first));
+                  ScopedConnection third;
+                  third = std::move(second);
+              }),
+              0);
+}
+
+TEST(Allocations, SignalHolderManagedConnect)
+{
+    if (PAJLADA_SIGNALS_LEAK_DETECTOR) {
+        GTEST_SKIP()
+            << "The leak detector allocates a string key on every connect";
+    }
+
+    Signal<int> signal;
+    reserveListeners(signal, 4);
+
+    SignalHolder holder;
+
+    // The first managed connection also creates the holder's group, and the
+    // first one to a signal registers the signal with the group, which grows
+    // a list on each side
+    EXPECT_EQ(countAllocations([&] {
+                  holder.managedConnect(signal, [](int) {});
+              }),
+              4);
+
+    EXPECT_EQ(countAllocations([&] {
+                  holder.managedConnect(signal, [](int) {});
+              }),
+              1);
+
+    // Clearing only invalidates the group
+    EXPECT_EQ(countAllocations([&] {
+                  holder.clear();
+              }),
+              0);
+}
+
+TEST(Allocations, OperatorPipeline)
+{
+    if (PAJLADA_SIGNALS_LEAK_DETECTOR) {
+        GTEST_SKIP()
+            << "The leak detector allocates a string key on every connect";
+    }
+
+    Signal<int> signal;
+    signal.setEmitStrategy(EmitStrategy::InPlace);
+    reserveListeners(signal, 4);
+
+    int sum = 0;
+    Connection conn;
+
+    // All operators end up in the single callback body
+    EXPECT_EQ(countAllocations([&] {
+                  conn = pipe(signal)
+                             .filter([](int v) {
+                                 return v > 0;
+                             })
+                             .map([](int v) {
+                                 return v * 2;
+                             })
+                             .distinct()
+                             .scan(0,
+                                   [](int total, int v) {
+                                       return total + v;
+                                   })
+                             .take(100)
+                             .connect([&sum](int total) {
+                                 sum = total;
+                             });
+              }),
+              1);
+
+    EXPECT_EQ(countAllocations([&] {
+                  signal.invoke(1);
+                  signal.invoke(2);
+              }),
+              0);
+    EXPECT_EQ(sum, 6);
+}
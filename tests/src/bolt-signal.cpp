@@ -2,6 +2,7 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
 #include <string>
 
 using namespace pajlada::Signals;
@@ -36,3 +37,40 @@ TEST(BoltSignal, InvokeOwned)
     signal.invoke(owned);
     EXPECT_TRUE(called);
 }
+
+TEST(BoltSignal, MoveOnlyCallback)
+{
+    BoltSignal<int> signal;
+
+    int result = 0;
+    auto value = std::make_unique<int>(5);
+    signal.connect([&result, value = std::move(value)](int multiplier) {
+        result = *value * multiplier;
+    });
+
+    signal.invoke(2);
+    EXPECT_EQ(result, 10);
+
+    // Callbacks only fire once
+    signal.invoke(3);
+    EXPECT_EQ(result, 10);
+}
+
+TEST(BoltSignal, ConnectWhileInvoking)
+{
+    NoArgBoltSignal signal;
+
+    int a = 0;
+    signal.connect([&] {
+        ++a;
+        signal.connect([&] {
+            a += 10;
+        });
+    });
+
+    signal.invoke();
+    EXPECT_EQ(a, 1);
+
+    signal.invoke();
+    EXPECT_EQ(a, 11);
+}
@@ -0,0 +1,158 @@
+#include <pajlada/signals/broadcast-signal.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace pajlada::Signals;
+
+namespace {
+
+struct Image {
+    explicit Image(int _width)
+        : width(_width)
+    {
+        ++constructions;
+    }
+
+    Image(const Image &other)
+        : width(other.width)
+    {
+        ++copies;
+    }
+
+    ~Image()
+    {
+        ++destructions;
+    }
+
+    int width;
+
+    static inline int constructions = 0;
+    static inline int copies = 0;
+    static inline int destructions = 0;
+
+    static void
+    reset()
+    {
+        constructions = 0;
+        copies = 0;
+        destructions = 0;
+    }
+};
+
+}  // namespace
+
+TEST(BroadcastSignal, SharedPayload)
+{
+    Image::reset();
+
+    BroadcastSignal<Image, std::string> signal;
+
+    std::vector<const Image *> seen;
+    std::vector<Connection> connections;
+    for (int i = 0; i < 10; ++i) {
+        connections.push_back(signal.connect(
+            [&](const BroadcastSignal<Image, std::string>::PayloadType &p) {
+                EXPECT_EQ(p.get<0>().width, 1920);
+                EXPECT_EQ(p.get<1>(), "frame");
+                seen.push_back(&p.get<0>());
+            }));
+    }
+
+    signal.invoke(1920, "frame");
+
+    ASSERT_EQ(seen.size(), 10);
+    for (const auto *image : seen) {
+        EXPECT_EQ(image, seen[0]);
+    }
+
+    EXPECT_EQ(Image::constructions, 1);
+    EXPECT_EQ(Image::copies, 0);
+    EXPECT_EQ(Image::destructions, 1);
+}
+
+TEST(BroadcastSignal, QueuedDelivery)
+{
+    Image::reset();
+
+    using ImageSignal = BroadcastSignal<Image>;
+    ImageSignal signal;
+
+    // Listeners hand the payload over to "other threads"
+    std::vector<ImageSignal::PayloadType> queueA;
+    std::vector<ImageSignal::PayloadType> queueB;
+    auto connA = signal.connect([&](const ImageSignal::PayloadType &p) {
+        queueA.push_back(p);
+    });
+    auto connB = signal.connect([&](const ImageSignal::PayloadType &p) {
+        queueB.push_back(p);
+    });
+
+    signal.invoke(640);
+
+    ASSERT_EQ(queueA.size(), 1);
+    EXPECT_EQ(queueA[0].getUseCount(), 2);
+    EXPECT_EQ(Image::copies, 0);
+    EXPECT_EQ(Image::destructions, 0);
+
+    queueA.clear();
+    EXPECT_EQ(Image::destructions, 0);
+
+    // Freed once the last consumer is done
+    queueB.clear();
+    EXPECT_EQ(Image::destructions, 1);
+}
+
+TEST(BroadcastSignal, NoListeners)
+{
+    Image::reset();
+
+    BroadcastSignal<Image> signal;
+    signal.invoke(1);
+
+    EXPECT_EQ(Image::constructions, 0);
+}
+
+TEST(BroadcastSignal, PayloadOutlivesSignal)
+{
+    Image::reset();
+
+    std::vector<BroadcastSignal<Image>::PayloadType> queue;
+    {
+        BroadcastSignal<Image> signal;
+        auto conn =
+            signal.connect([&](const BroadcastSignal<Image>::PayloadType &p) {
+                queue.push_back(p);
+            });
+
+        for (int i = 0; i < 3; ++i) {
+            signal.invoke(i);
+        }
+    }
+
+    ASSERT_EQ(queue.size(), 3);
+    EXPECT_EQ(queue[2].get<0>().width, 2);
+
+    queue.clear();
+    EXPECT_EQ(Image::destructions, 3);
+}
+
+TEST(BroadcastSignal, RecyclesPayloadBlocks)
+{
+    BroadcastSignal<Image> signal;
+
+    std::vector<const Image *> seen;
+    auto conn =
+        signal.connect([&](const BroadcastSignal<Image>::PayloadType &p) {
+            seen.push_back(&p.get<0>());
+        });
+
+    signal.invoke(1);
+    signal.invoke(2);
+
+    // The first payload's block was returned to the pool and reused
+    ASSERT_EQ(seen.size(), 2);
+    EXPECT_EQ(seen[0], seen[1]);
+}
@@ -0,0 +1,184 @@
+#include <pajlada/signals/combiners.hpp>
+#include <pajlada/signals/signal.hpp>
+
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace pajlada::Signals;
+
+TEST(Combiners, AnyTrueShortCircuits)
+{
+    Signal<bool(const std::string &)> vetoClose;
+
+    int calls = 0;
+    auto connA = vetoClose.connect([&](const std::string &) {
+        ++calls;
+        return false;
+    });
+    auto connB = vetoClose.connect([&](const std::string &name) {
+        ++calls;
+        return name == "unsaved";
+    });
+    auto connC = vetoClose.connect([&](const std::string &) {
+        ++calls;
+        return false;
+    });
+
+    EXPECT_FALSE(vetoClose.collect(combiners::AnyTrue{}, "saved"));
+    EXPECT_EQ(calls, 3);
+
+    calls = 0;
+    EXPECT_TRUE(vetoClose.collect(combiners::AnyTrue{}, "unsaved"));
+    EXPECT_EQ(calls, 2);
+
+    // Blocked listeners don't get a vote
+    calls = 0;
+    connB.block();
+    EXPECT_FALSE(vetoClose.collect(combiners::AnyTrue{}, "unsaved"));
+    EXPECT_EQ(calls, 2);
+}
+
+TEST(Combiners, AllTrue)
+{
+    Signal<bool(int)> validate;
+
+    EXPECT_TRUE(validate.collect(combiners::AllTrue{}, 1));
+
+    int calls = 0;
+    auto connA = validate.connect([&](int v) {
+        ++calls;
+        return v > 0;
+    });
+    auto connB = validate.connect([&](int v) {
+        ++calls;
+        return v < 10;
+    });
+
+    EXPECT_TRUE(validate.collect(combiners::AllTrue{}, 5));
+    EXPECT_EQ(calls, 2);
+
+    calls = 0;
+    EXPECT_FALSE(validate.collect(combiners::AllTrue{}, -1));
+    EXPECT_EQ(calls, 1);
+
+    connA.disconnect();
+    calls = 0;
+    EXPECT_TRUE(validate.collect(combiners::AllTrue{}, -1));
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(Combiners, Sum)
+{
+    Signal<size_t()> sizes;
+
+    auto connA = sizes.connect([] {
+        return size_t(3);
+    });
+    auto connB = sizes.connect([] {
+        return size_t(4);
+    });
+
+    EXPECT_EQ(sizes.collect(combiners::Sum<size_t>{}), 7);
+}
+
+TEST(Combiners, FirstNonEmpty)
+{
+    Signal<std::optional<std::string>(int)> lookup;
+
+    int calls = 0;
+    auto connA = lookup.connect([&](int) -> std::optional<std::string> {
+        ++calls;
+        return std::nullopt;
+    });
+    auto connB = lookup.connect([&](int key) -> std::optional<std::string> {
+        ++calls;
+        if (key == 1) {
+            return "one";
+        }
+        return std::nullopt;
+    });
+    auto connC = lookup.connect([&](int) -> std::optional<std::string> {
+        ++calls;
+        return "fallback";
+    });
+
+    auto result =
+        lookup.collect(combiners::FirstNonEmpty<std::optional<std::string>>{},
+                       1);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(*result, "one");
+    EXPECT_EQ(calls, 2);
+
+    combiners::FirstNonEmpty<std::optional<std::string>> combiner;
+    EXPECT_EQ(lookup.collect(combiner, 2), "fallback");
+}
+
+TEST(Combiners, CollectInto)
+{
+    Signal<int(int)> signal;
+
+    auto connA = signal.connect(
+        [](int v) {
+            return v * 2;
+        },
+        1);
+    auto connB = signal.connect(
+        [](int v) {
+            return v * 3;
+        },
+        2);
+    auto connC = signal.connect([](int v) {
+        return v * 4;
+    });
+
+    std::vector<int> results;
+    results.reserve(3);
+
+    EXPECT_EQ(signal.collect(combiners::CollectInto(results), 1), 3);
+    std::vector<int> expected{3, 2, 4};
+    EXPECT_EQ(results, expected);
+
+    results.clear();
+    EXPECT_EQ(signal.collect(combiners::CollectInto(results, 2), 1), 2);
+    expected = {3, 2};
+    EXPECT_EQ(results, expected);
+
+    results.clear();
+    EXPECT_EQ(signal.collect(combiners::CollectInto(results, 0), 1), 0);
+    EXPECT_TRUE(results.empty());
+}
+
+namespace {
+
+class Document
+{
+public:
+    bool
+    hasUnsavedChanges(const std::string &)
+    {
+        return this->dirty;
+    }
+
+    bool dirty = false;
+};
+
+}  // namespace
+
+TEST(Combiners, MemberListener)
+{
+    Signal<bool(const std::string &)> vetoClose;
+    Document document;
+
+    auto conn = vetoClose.connect<&Document::hasUnsavedChanges>(&document);
+
+    EXPECT_FALSE(vetoClose.collect(combiners::AnyTrue{}, "doc"));
+    document.dirty = true;
+    EXPECT_TRUE(vetoClose.collect(combiners::AnyTrue{}, "doc"));
+
+    // Plain invoke still calls everyone, ignoring the results
+    vetoClose.invoke("doc");
+    EXPECT_EQ(vetoClose.getListenerCount(), 1);
+}
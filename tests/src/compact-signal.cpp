@@ -0,0 +1,137 @@
+#include <pajlada/signals/compact-signal.hpp>
+#include <pajlada/signals/scoped-connection.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pajlada::Signals;
+
+static_assert(sizeof(CompactSignal<int>) == sizeof(void *),
+              "CompactSignal must stay pointer-sized");
+
+TEST(CompactSignal, InvokeWithoutListeners)
+{
+    CompactSignal<int> signal;
+
+    signal.invoke(1);
+
+    EXPECT_FALSE(signal.isAllocated());
+}
+
+TEST(CompactSignal, SingleConnect)
+{
+    CompactSignal<int> incrementSignal;
+    int a = 0;
+    auto IncrementA = [&a](int incrementBy) {
+        a += incrementBy;  //
+    };
+
+    auto conn = incrementSignal.connect(IncrementA);
+    EXPECT_TRUE(incrementSignal.isAllocated());
+
+    incrementSignal.invoke(1);
+    EXPECT_EQ(a, 1);
+
+    incrementSignal.invoke(2);
+    EXPECT_EQ(a, 3);
+
+    EXPECT_TRUE(conn.disconnect());
+
+    incrementSignal.invoke(2);
+    EXPECT_EQ(a, 3);
+}
+
+TEST(CompactSignal, ScopedConnection)
+{
+    CompactSignal<int> incrementSignal;
+    int a = 0;
+    auto IncrementA = [&a](int incrementBy) {
+        a += incrementBy;  //
+    };
+
+    {
+        ScopedConnection conn(incrementSignal.connect(IncrementA));
+        incrementSignal.invoke(1);
+        EXPECT_EQ(a, 1);
+    }
+
+    incrementSignal.invoke(1);
+    EXPECT_EQ(a, 1);
+}
+
+TEST(CompactSignal, InvokeOwned)
+{
+    CompactSignal<std::string> signal;
+
+    bool called = false;
+    auto consumerOwned = [&](std::string s) {
+        EXPECT_EQ(s, "Yes, this is a really long long string!");
+        called = true;
+    };
+    auto consumerConstRef = [&](const std::string &s) {
+        EXPECT_EQ(s, "Yes, this is a really long long string!");
+        called = true;
+    };
+    auto connA = signal.connect(consumerOwned);
+    auto connB = signal.connect(consumerConstRef);
+
+    signal.invoke("Yes, this is a really long long string!");
+    EXPECT_TRUE(called);
+    called = false;
+
+    std::string owned = "Yes, this is a really long long string!";
+    signal.invoke(owned);
+    EXPECT_TRUE(called);
+    EXPECT_EQ(owned, "Yes, this is a really long long string!");
+}
+
+TEST(CompactSignal, ConcurrentFirstConnect)
+{
+    NoArgCompactSignal signal;
+    std::atomic<int> calls{0};
+
+    std::vector<std::thread> threads;
+    std::vector<Connection> connections(8);
+    for (size_t i = 0; i < connections.size(); ++i) {
+        threads.emplace_back([&, i] {
+            connections[i] = signal.connect([&] {
+                ++calls;
+            });
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    signal.invoke();
+    EXPECT_EQ(calls, 8);
+}
+
+TEST(CompactSignal, MemoryUsage)
+{
+    CompactSignal<int> signal;
+
+    auto empty = signal.getMemoryUsage();
+    EXPECT_EQ(empty.liveListeners, 0);
+    EXPECT_EQ(empty.capacity, 0);
+    EXPECT_EQ(empty.estimatedBytes, sizeof(signal));
+
+    auto a = signal.connect([](int) {});
+    auto b = signal.connect([](int) {});
+    b.disconnect();
+
+    auto usage = signal.getMemoryUsage();
+    EXPECT_EQ(usage.liveListeners, 1);
+    EXPECT_EQ(usage.deadListeners, 1);
+    EXPECT_GT(usage.estimatedBytes, sizeof(CompactSignal<int>::SignalType));
+
+    signal.compact();
+
+    usage = signal.getMemoryUsage();
+    EXPECT_EQ(usage.liveListeners, 1);
+    EXPECT_EQ(usage.deadListeners, 0);
+    EXPECT_EQ(usage.capacity, 1);
+}
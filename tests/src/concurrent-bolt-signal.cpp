@@ -0,0 +1,139 @@
+#include <pajlada/signals/concurrent-bolt-signal.hpp>
+#include <pajlada/signals/connection.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pajlada::Signals;
+
+TEST(ConcurrentBoltSignal, InvokeOnce)
+{
+    ConcurrentBoltSignal<int> signal;
+
+    std::vector<int> calls;
+    signal.connect([&](int v) {
+        calls.push_back(v);
+    });
+    signal.connect([&](int v) {
+        calls.push_back(v + 100);
+    });
+
+    EXPECT_FALSE(signal.isFired());
+    signal.invoke(1);
+    EXPECT_TRUE(signal.isFired());
+
+    // Fired in connect order
+    ASSERT_EQ(calls.size(), 2);
+    EXPECT_EQ(calls[0], 1);
+    EXPECT_EQ(calls[1], 101);
+
+    // Further invokes are ignored
+    signal.invoke(2);
+    EXPECT_EQ(calls.size(), 2);
+}
+
+TEST(ConcurrentBoltSignal, ConnectAfterFire)
+{
+    ConcurrentBoltSignal<std::string> signal;
+
+    signal.invoke("Yes, this is a really long long string!");
+
+    bool called = false;
+    signal.connect([&](const std::string &s) {
+        EXPECT_EQ(s, "Yes, this is a really long long string!");
+        called = true;
+    });
+    EXPECT_TRUE(called);
+
+    called = false;
+    signal.connect([&](std::string s) {
+        EXPECT_EQ(s, "Yes, this is a really long long string!");
+        called = true;
+    });
+    EXPECT_TRUE(called);
+}
+
+TEST(ConcurrentBoltSignal, MoveOnlyCallback)
+{
+    ConcurrentBoltSignal<int> signal;
+
+    int result = 0;
+    auto value = std::make_unique<int>(5);
+    signal.connect([&result, value = std::move(value)](int multiplier) {
+        result = *value * multiplier;
+    });
+
+    signal.invoke(2);
+    EXPECT_EQ(result, 10);
+}
+
+TEST(ConcurrentBoltSignal, NeverFired)
+{
+    auto shared = std::make_shared<int>(1);
+    std::weak_ptr<int> weak(shared);
+
+    {
+        NoArgConcurrentBoltSignal signal;
+        signal.connect([shared = std::move(shared)] {});
+    }
+
+    EXPECT_TRUE(weak.expired());
+}
+
+#if PAJLADA_SIGNALS_EXCEPTIONS
+TEST(ConcurrentBoltSignal, ThrowingCallbackFreesTheRest)
+{
+    auto shared = std::make_shared<int>(1);
+    std::weak_ptr<int> weak(shared);
+
+    {
+        NoArgConcurrentBoltSignal signal;
+        signal.connect([] {
+            throw std::runtime_error("first");
+        });
+        signal.connect([shared = std::move(shared)] {});
+
+        EXPECT_THROW(signal.invoke(), std::runtime_error);
+        EXPECT_TRUE(signal.isFired());
+    }
+
+    EXPECT_TRUE(weak.expired());
+}
+#endif
+
+TEST(ConcurrentBoltSignal, NoLostWakeups)
+{
+    constexpr int threadCount = 4;
+    constexpr int connectsPerThread = 1000;
+
+    ConcurrentBoltSignal<int> signal;
+    std::atomic<int> calls{0};
+    std::atomic<int> sum{0};
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < connectsPerThread; ++j) {
+                signal.connect([&](int v) {
+                    ++calls;
+                    sum += v;
+                });
+            }
+        });
+    }
+
+    signal.invoke(1);
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(calls, threadCount * connectsPerThread);
+    EXPECT_EQ(sum, threadCount * connectsPerThread);
+}
@@ -387,3 +387,27 @@ TEST(Connection, AssignmentOperatorMoveSelf)
     incrementSignal.invoke(1);
     EXPECT_EQ(a, 3);
 }
+
+TEST(Connection, OutlivesSignal)
+{
+    Connection conn;
+    Connection blockedConn;
+
+    {
+        Signal<int> signal;
+        conn = signal.connect([](int) {});
+        blockedConn = signal.connect([](int) {});
+        EXPECT_TRUE(blockedConn.block());
+    }
+
+    // The bodies are kept alive by the connections, but they expired along
+    // with their signal
+    Connection copy(conn);
+    EXPECT_FALSE(copy.isConnected());
+    EXPECT_FALSE(conn.isConnected());
+    EXPECT_FALSE(blockedConn.isBlocked());
+    EXPECT_FALSE(blockedConn.unblock());
+    EXPECT_FALSE(conn.getSubscriberRefCount().connected);
+    EXPECT_FALSE(conn.disconnect());
+    EXPECT_FALSE(copy.disconnect());
+}
@@ -0,0 +1,366 @@
+#include <pajlada/signals/dense-signal.hpp>
+#include <pajlada/signals/scoped-connection.hpp>
+#include <pajlada/signals/signalholder.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace pajlada::Signals;
+
+TEST(DenseSignal, ConnectDisconnect)
+{
+    DenseSignal<int> incrementSignal;
+    int a = 0;
+    auto IncrementA = [&a](int incrementBy) {
+        a += incrementBy;  //
+    };
+
+    incrementSignal.invoke(1);
+    EXPECT_EQ(a, 0);
+
+    auto connA = incrementSignal.connect(IncrementA);
+    auto connB = incrementSignal.connect(IncrementA);
+    EXPECT_EQ(incrementSignal.getListenerCount(), 2);
+
+    incrementSignal.invoke(1);
+    EXPECT_EQ(a, 2);
+
+    EXPECT_TRUE(connA.disconnect());
+    incrementSignal.invoke(1);
+    EXPECT_EQ(a, 3);
+
+    {
+        ScopedConnection scoped(incrementSignal.connect(IncrementA));
+        incrementSignal.invoke(1);
+        EXPECT_EQ(a, 5);
+    }
+
+    incrementSignal.invoke(1);
+    EXPECT_EQ(a, 6);
+    EXPECT_EQ(incrementSignal.getListenerCount(), 1);
+}
+
+TEST(DenseSignal, BlockUnblock)
+{
+    DenseSignal<int> signal;
+    int a = 0;
+    int b = 0;
+
+    auto connA = signal.connect([&](int v) {
+        a += v;
+    });
+    auto connB = signal.connect([&](int v) {
+        b += v;
+    });
+
+    EXPECT_TRUE(connA.block());
+    EXPECT_FALSE(connA.block());
+    signal.invoke(1);
+    EXPECT_EQ(a, 0);
+    EXPECT_EQ(b, 1);
+
+    // Blocked listeners are still connected
+    EXPECT_EQ(signal.getListenerCount(), 2);
+
+    EXPECT_TRUE(connA.unblock());
+    signal.invoke(1);
+    EXPECT_EQ(a, 1);
+    EXPECT_EQ(b, 2);
+}
+
+TEST(DenseSignal, ManyListeners)
+{
+    constexpr int listenerCount = 1000;
+
+    DenseSignal<int> signal;
+    int sum = 0;
+
+    std::vector<Connection> connections;
+    for (int i = 0; i < listenerCount; ++i) {
+        connections.push_back(signal.connect([&](int v) {
+            sum += v;
+        }));
+    }
+
+    signal.invoke(1);
+    EXPECT_EQ(sum, listenerCount);
+
+    // Block every other listener and disconnect every fourth
+    for (int i = 0; i < listenerCount; i += 2) {
+        connections[i].block();
+    }
+    for (int i = 1; i < listenerCount; i += 4) {
+        connections[i].disconnect();
+    }
+
+    sum = 0;
+    signal.invoke(1);
+    EXPECT_EQ(sum, listenerCount / 4);
+    EXPECT_EQ(signal.getListenerCount(), listenerCount * 3 / 4);
+}
+
+TEST(DenseSignal, ReusesSlots)
+{
+    DenseSignal<int> signal;
+    int calls = 0;
+
+    for (int round = 0; round < 10; ++round) {
+        std::vector<Connection> connections;
+        for (int i = 0; i < 300; ++i) {
+            connections.push_back(signal.connect([&](int) {
+                ++calls;
+            }));
+        }
+
+        for (auto &connection : connections) {
+            connection.disconnect();
+        }
+    }
+
+    signal.invoke(1);
+    EXPECT_EQ(calls, 0);
+
+    // Room for 300 listeners, rounded up to whole chunks
+    EXPECT_LT(signal.getSlotCount(), 600);
+}
+
+TEST(DenseSignal, ConnectDuringInvoke)
+{
+    NoArgDenseSignal signal;
+    int outerCalls = 0;
+    int innerCalls = 0;
+    std::vector<Connection> connections;
+
+    auto conn = signal.connect([&] {
+        ++outerCalls;
+        connections.emplace_back(signal.connect([&] {
+            ++innerCalls;
+        }));
+    });
+
+    // Listeners connected during an invoke wait for the next one
+    signal.invoke();
+    EXPECT_EQ(outerCalls, 1);
+    EXPECT_EQ(innerCalls, 0);
+
+    signal.invoke();
+    EXPECT_EQ(outerCalls, 2);
+    EXPECT_EQ(innerCalls, 1);
+    EXPECT_EQ(signal.getListenerCount(), 3);
+}
+
+TEST(DenseSignal, OverlappingInvokes)
+{
+    DenseSignal<int> signal;
+
+    std::atomic<bool> shouldPark{true};
+    std::atomic<bool> parked{false};
+    std::atomic<bool> resume{false};
+
+    auto parking = signal.connect([&](int) {
+        if (shouldPark.exchange(false)) {
+            parked = true;
+            while (!resume) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::thread other([&] {
+        signal.invoke(1);
+    });
+    while (!parked) {
+        std::this_thread::yield();
+    }
+
+    // The other thread is still inside its invoke, ours starts after the
+    // connect so it has to see the new listener
+    int newCalls = 0;
+    auto added = signal.connect([&newCalls](int) {
+        ++newCalls;
+    });
+    signal.invoke(2);
+    EXPECT_EQ(newCalls, 1);
+
+    // Slots freed meanwhile are reused without waiting for the other invoke
+    int churnCalls = 0;
+    for (int i = 0; i < 1000; ++i) {
+        auto churn = signal.connect([&churnCalls](int) {
+            ++churnCalls;
+        });
+        signal.invoke(3);
+        churn.disconnect();
+        signal.invoke(4);
+    }
+    EXPECT_EQ(churnCalls, 1000);
+    EXPECT_EQ(newCalls, 2001);
+    EXPECT_EQ(signal.getSlotCount(), 256);
+
+    resume = true;
+    other.join();
+
+    // The other invoke started before the connect
+    EXPECT_EQ(newCalls, 2001);
+}
+
+TEST(DenseSignal, DisconnectDuringInvoke)
+{
+    NoArgDenseSignal signal;
+    int calls = 0;
+    std::vector<Connection> connections;
+
+    for (int i = 0; i < 4; ++i) {
+        connections.push_back(signal.connect([&] {
+            ++calls;
+
+            // Whoever is called first disconnects everyone
+            for (auto &connection : connections) {
+                connection.disconnect();
+            }
+        }));
+    }
+
+    signal.invoke();
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(signal.getListenerCount(), 0);
+
+    signal.invoke();
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(DenseSignal, StopPropagation)
+{
+    DenseSignal<int> signal;
+    int calls = 0;
+
+    auto connA = signal.connect([&](int) {
+        ++calls;
+        return Propagation::Stop;
+    });
+    auto connB = signal.connect([&](int) {
+        ++calls;
+    });
+
+    signal.invoke(1);
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(DenseSignal, SignalHolder)
+{
+    DenseSignal<int> signal;
+    int a = 0;
+
+    {
+        SignalHolder holder;
+        holder.managedConnect(signal, [&](int v) {
+            a += v;
+        });
+
+        signal.invoke(1);
+        EXPECT_EQ(a, 1);
+    }
+
+    // Disconnected through the holder's group
+    signal.invoke(1);
+    EXPECT_EQ(a, 1);
+    EXPECT_EQ(signal.getListenerCount(), 0);
+}
+
+TEST(DenseSignal, DisconnectAfterSignalDestroyed)
+{
+    Connection conn;
+
+    {
+        DenseSignal<int> signal;
+        conn = signal.connect([](int) {});
+        EXPECT_TRUE(conn.isConnected());
+    }
+
+    EXPECT_FALSE(conn.isConnected());
+    EXPECT_FALSE(conn.block());
+    EXPECT_FALSE(conn.disconnect());
+}
+
+TEST(DenseSignal, BlockFromManyThreads)
+{
+    constexpr int threadCount = 4;
+    constexpr int listenersPerThread = 100;
+
+    DenseSignal<int> signal;
+    std::atomic<int> sum{0};
+
+    std::vector<Connection> connections;
+    for (int i = 0; i < threadCount * listenersPerThread; ++i) {
+        connections.push_back(signal.connect([&](int v) {
+            sum += v;
+        }));
+    }
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back([&, i] {
+            for (int round = 0; round < 50; ++round) {
+                for (int j = 0; j < listenersPerThread; ++j) {
+                    auto &connection = connections[i * listenersPerThread + j];
+                    connection.block();
+                    connection.unblock();
+                }
+            }
+        });
+    }
+    for (int round = 0; round < 50; ++round) {
+        signal.invoke(0);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    signal.invoke(1);
+    EXPECT_EQ(sum, threadCount * listenersPerThread);
+}
+
+TEST(DenseSignal, MemoryUsage)
+{
+    DenseSignal<int> signal;
+    SignalHolder holder;
+    std::vector<Connection> connections;
+
+    for (int i = 0; i < 300; ++i) {
+        connections.push_back(signal.connect([](int) {}));
+    }
+    holder.managedConnect(signal, [](int) {});
+
+    auto usage = signal.getMemoryUsage();
+    EXPECT_EQ(usage.liveListeners, 301);
+    EXPECT_EQ(usage.deadListeners, 0);
+    EXPECT_EQ(usage.capacity, 512);
+    EXPECT_GT(usage.estimatedBytes, sizeof(signal));
+
+    for (auto &connection : connections) {
+        connection.disconnect();
+    }
+    holder.clear();
+
+    usage = signal.getMemoryUsage();
+    EXPECT_EQ(usage.liveListeners, 0);
+    EXPECT_EQ(usage.deadListeners, 301);
+
+    signal.compact();
+
+    usage = signal.getMemoryUsage();
+    EXPECT_EQ(usage.deadListeners, 0);
+    EXPECT_EQ(usage.capacity, 0);
+    EXPECT_EQ(signal.getSlotCount(), 0);
+
+    // Grows again after compacting
+    int calls = 0;
+    auto conn = signal.connect([&calls](int) {
+        ++calls;
+    });
+    signal.invoke(1);
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(signal.getSlotCount(), 256);
+}
@@ -0,0 +1,154 @@
+#include <pajlada/signals/event-bus.hpp>
+#include <pajlada/signals/scoped-connection.hpp>
+#include <pajlada/signals/signalholder.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pajlada::Signals;
+
+namespace {
+
+struct UserJoined {
+    std::string name;
+};
+
+struct UserLeft {
+    std::string name;
+};
+
+struct MessageCount {
+    int count = 0;
+
+    void
+    onMessage(const UserJoined & /*event*/)
+    {
+        ++this->count;
+    }
+};
+
+}  // namespace
+
+TEST(EventBus, PublishWithoutSubscribers)
+{
+    EventBus bus;
+
+    bus.publish(UserJoined{"forsen"});
+
+    EXPECT_EQ(bus.getListenerCount<UserJoined>(), 0);
+}
+
+TEST(EventBus, SubscribeByType)
+{
+    EventBus bus;
+    std::vector<std::string> joined;
+    std::vector<std::string> left;
+
+    auto connJoined = bus.subscribe<UserJoined>([&](const UserJoined &event) {
+        joined.push_back(event.name);
+    });
+    auto connLeft = bus.subscribe<UserLeft>([&](const UserLeft &event) {
+        left.push_back(event.name);
+    });
+
+    bus.publish(UserJoined{"a"});
+    bus.publish(UserLeft{"b"});
+    bus.publish(UserJoined{"c"});
+
+    EXPECT_EQ(joined, (std::vector<std::string>{"a", "c"}));
+    EXPECT_EQ(left, (std::vector<std::string>{"b"}));
+    EXPECT_EQ(bus.getListenerCount<UserJoined>(), 1);
+
+    EXPECT_TRUE(connJoined.disconnect());
+    bus.publish(UserJoined{"d"});
+    EXPECT_EQ(joined.size(), 2);
+    EXPECT_EQ(bus.getListenerCount<UserJoined>(), 0);
+}
+
+TEST(EventBus, MemberSubscribe)
+{
+    EventBus bus;
+    MessageCount counter;
+
+    ScopedConnection conn(
+        bus.subscribe<UserJoined, &MessageCount::onMessage>(&counter));
+
+    bus.publish(UserJoined{"a"});
+    bus.publish(UserJoined{"b"});
+    EXPECT_EQ(counter.count, 2);
+}
+
+TEST(EventBus, SignalHolder)
+{
+    EventBus bus;
+    int calls = 0;
+
+    {
+        SignalHolder holder;
+        holder.managedConnect(bus.getSignal<UserJoined>(),
+                              [&](const UserJoined &) {
+                                  ++calls;
+                              });
+
+        bus.publish(UserJoined{"a"});
+        EXPECT_EQ(calls, 1);
+    }
+
+    bus.publish(UserJoined{"a"});
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(EventBus, BusesAreIndependent)
+{
+    EventBus first;
+    EventBus second;
+    int calls = 0;
+
+    auto conn = first.subscribe<UserJoined>([&](const UserJoined &) {
+        ++calls;
+    });
+
+    second.publish(UserJoined{"a"});
+    EXPECT_EQ(calls, 0);
+
+    first.publish(UserJoined{"a"});
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(EventBus, ConcurrentFirstSubscribe)
+{
+    EventBus bus;
+    std::atomic<int> calls{0};
+
+    std::vector<std::thread> threads;
+    std::vector<Connection> connections(8);
+    for (size_t i = 0; i < connections.size(); ++i) {
+        threads.emplace_back([&, i] {
+            connections[i] = bus.subscribe<UserLeft>([&](const UserLeft &) {
+                ++calls;
+            });
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    bus.publish(UserLeft{"a"});
+    EXPECT_EQ(calls, 8);
+}
+
+TEST(EventBus, TooManyEventTypesAborts)
+{
+    EXPECT_DEATH(
+        {
+            for (std::size_t i = 0; i <= EventBus::MAX_EVENT_TYPES; ++i) {
+                pajlada::Signals::detail::nextEventTypeId();
+            }
+        },
+        "more than 4096 event types");
+}
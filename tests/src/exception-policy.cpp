@@ -0,0 +1,208 @@
+#include <pajlada/signals/signal.hpp>
+
+#include <gtest/gtest.h>
+
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace pajlada::Signals;
+
+namespace {
+
+struct Listener {
+    void
+    onValue(int /*value*/) noexcept
+    {
+    }
+
+    void
+    onValueThrowing(int /*value*/)
+    {
+    }
+};
+
+}  // namespace
+
+TEST(ExceptionPolicy, MayThrow)
+{
+    auto plain = detail::makeBody<
+        detail::FunctionCallbackBody<void (*)(int), int>>(+[](int) {});
+    EXPECT_TRUE(plain->mayThrow());
+
+    auto lambda = [](int) noexcept {};
+    auto nothrow = detail::makeBody<
+        detail::FunctionCallbackBody<decltype(lambda), int>>(lambda);
+    EXPECT_FALSE(nothrow->mayThrow());
+
+    Listener listener;
+    auto member = detail::makeBody<
+        detail::MemberCallbackBody<&Listener::onValue, Listener, int>>(
+        &listener);
+    EXPECT_FALSE(member->mayThrow());
+
+    auto throwingMember = detail::makeBody<
+        detail::MemberCallbackBody<&Listener::onValueThrowing, Listener, int>>(
+        &listener);
+    EXPECT_TRUE(throwingMember->mayThrow());
+}
+
+TEST(ExceptionPolicy, DefaultIsPropagate)
+{
+    Signal<int> signal;
+    EXPECT_EQ(signal.getExceptionPolicy(), ExceptionPolicy::Propagate);
+
+    signal.setExceptionPolicy(ExceptionPolicy::Report);
+    EXPECT_EQ(signal.getExceptionPolicy(), ExceptionPolicy::Report);
+}
+
+#if PAJLADA_SIGNALS_EXCEPTIONS
+
+TEST(ExceptionPolicy, Propagate)
+{
+    for (auto strategy : {EmitStrategy::Snapshot, EmitStrategy::InPlace}) {
+        Signal<int> signal;
+        signal.setEmitStrategy(strategy);
+
+        std::vector<int> calls;
+        auto c1 = signal.connect([&calls](int value) {
+            calls.push_back(value);
+            throw std::runtime_error("first");
+        });
+        auto c2 = signal.connect([&calls](int value) {
+            calls.push_back(value * 10);
+        });
+
+        EXPECT_THROW(signal.invoke(1), std::runtime_error);
+        EXPECT_EQ(calls, (std::vector<int>{1}));
+
+        // The signal is still usable afterwards
+        c1.disconnect();
+        signal.invoke(2);
+        EXPECT_EQ(calls, (std::vector<int>{1, 20}));
+    }
+}
+
+TEST(ExceptionPolicy, RethrowFirst)
+{
+    for (auto strategy : {EmitStrategy::Snapshot, EmitStrategy::InPlace}) {
+        Signal<int> signal;
+        signal.setEmitStrategy(strategy);
+        signal.setExceptionPolicy(ExceptionPolicy::RethrowFirst);
+
+        std::vector<int> calls;
+        auto c1 = signal.connect([&calls](int value) {
+            calls.push_back(value);
+            throw std::runtime_error("first");
+        });
+        auto c2 = signal.connect([&calls](int value) noexcept {
+            calls.push_back(value * 10);
+        });
+        auto c3 = signal.connect([&calls](int value) {
+            calls.push_back(value * 100);
+            throw std::logic_error("second");
+        });
+
+        try {
+            signal.invoke(1);
+            FAIL() << "invoke should have thrown";
+        } catch (const std::runtime_error &e) {
+            EXPECT_EQ(std::string(e.what()), "first");
+        }
+
+        EXPECT_EQ(calls, (std::vector<int>{1, 10, 100}));
+    }
+}
+
+TEST(ExceptionPolicy, Report)
+{
+    Signal<int> signal;
+    signal.setExceptionPolicy(ExceptionPolicy::Report);
+
+    std::vector<std::string> reported;
+    signal.setExceptionHandler([&reported](std::exception_ptr exception) {
+        try {
+            std::rethrow_exception(exception);
+        } catch (const std::exception &e) {
+            reported.emplace_back(e.what());
+        }
+    });
+
+    int calls = 0;
+    auto c1 = signal.connect([&calls](int) {
+        ++calls;
+        throw std::runtime_error("first");
+    });
+    auto c2 = signal.connect([&calls](int) {
+        ++calls;
+    });
+    auto c3 = signal.connect([&calls](int) {
+        ++calls;
+        throw std::runtime_error("second");
+    });
+
+    EXPECT_NO_THROW(signal.invoke(1));
+    EXPECT_EQ(calls, 3);
+    EXPECT_EQ(reported, (std::vector<std::string>{"first", "second"}));
+}
+
+TEST(ExceptionPolicy, ReportWithoutHandler)
+{
+    Signal<int> signal;
+    signal.setExceptionPolicy(ExceptionPolicy::Report);
+
+    int calls = 0;
+    auto c1 = signal.connect([](int) {
+        throw std::runtime_error("dropped");
+    });
+    auto c2 = signal.connect([&calls](int) {
+        ++calls;
+    });
+
+    EXPECT_NO_THROW(signal.invoke(1));
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(ExceptionPolicy, StopStillWorks)
+{
+    Signal<int> signal;
+    signal.setExceptionPolicy(ExceptionPolicy::RethrowFirst);
+
+    std::vector<int> calls;
+    auto c1 = signal.connect([&calls](int) {
+        calls.push_back(1);
+        return Propagation::Stop;
+    });
+    auto c2 = signal.connect([&calls](int) {
+        calls.push_back(2);
+    });
+
+    signal.invoke(1);
+    EXPECT_EQ(calls, (std::vector<int>{1}));
+}
+
+TEST(ExceptionPolicy, InPlaceLeavesIterationOnThrow)
+{
+    Signal<int> signal;
+    signal.setEmitStrategy(EmitStrategy::InPlace);
+
+    auto c1 = signal.connect([](int) {
+        throw std::runtime_error("first");
+    });
+
+    EXPECT_THROW(signal.invoke(1), std::runtime_error);
+
+    // Connecting again would wait in the pending list forever if the
+    // iteration had not been left
+    int calls = 0;
+    c1.disconnect();
+    auto c2 = signal.connect([&calls](int) {
+        ++calls;
+    });
+    signal.invoke(1);
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(signal.getMemoryUsage().deadListeners, 0);
+}
+
+#endif
@@ -0,0 +1,392 @@
+#include <pajlada/signals/signal.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pajlada::Signals;
+
+namespace {
+
+// Runs tasks only when asked to
+class ManualExecutor
+{
+public:
+    void
+    operator()(std::function<void()> task)
+    {
+        this->tasks.emplace_back(std::move(task));
+    }
+
+    void
+    runOne()
+    {
+        auto task = std::move(this->tasks.front());
+        this->tasks.pop_front();
+        task();
+    }
+
+    void
+    runAll()
+    {
+        while (!this->tasks.empty()) {
+            this->runOne();
+        }
+    }
+
+    std::deque<std::function<void()>> tasks;
+};
+
+// Runs tasks on a fixed set of threads
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int threadCount)
+    {
+        for (int i = 0; i < threadCount; ++i) {
+            this->threads.emplace_back([this] {
+                this->run();
+            });
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->stopping = true;
+        }
+        this->condition.notify_all();
+
+        for (auto &thread : this->threads) {
+            thread.join();
+        }
+    }
+
+    void
+    post(std::function<void()> task)
+    {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->tasks.emplace_back(std::move(task));
+        }
+        this->condition.notify_one();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::function<void()>> tasks;
+    bool stopping{false};
+    std::vector<std::thread> threads;
+
+    void
+    run()
+    {
+        while (true) {
+            std::function<void()> task;
+
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->condition.wait(lock, [this] {
+                    return this->stopping || !this->tasks.empty();
+                });
+
+                if (this->tasks.empty()) {
+                    return;
+                }
+
+                task = std::move(this->tasks.front());
+                this->tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+};
+
+}  // namespace
+
+TEST(InvokeCompletion, DefaultIsDone)
+{
+    InvokeCompletion completion;
+    EXPECT_TRUE(completion.isDone());
+    completion.wait();
+
+    bool called = false;
+    completion.then([&called] {
+        called = true;
+    });
+    EXPECT_TRUE(called);
+}
+
+TEST(InvokeCompletion, InlineExecutor)
+{
+    Signal<int> signal;
+    int a = 0;
+    auto IncrementA = [&a](int incrementBy) {
+        a += incrementBy;  //
+    };
+
+    auto c1 = signal.connect(IncrementA);
+    auto c2 = signal.connect(IncrementA);
+
+    auto completion = signal.invokeAsync(
+        [](auto task) {
+            task();
+        },
+        2);
+
+    EXPECT_EQ(a, 4);
+    EXPECT_TRUE(completion.isDone());
+}
+
+TEST(InvokeCompletion, NoListeners)
+{
+    Signal<int> signal;
+    int tasks = 0;
+
+    auto completion = signal.invokeAsync(
+        [&tasks](auto task) {
+            ++tasks;
+            task();
+        },
+        1);
+
+    EXPECT_EQ(tasks, 0);
+    EXPECT_TRUE(completion.isDone());
+}
+
+TEST(InvokeCompletion, ThenRunsAfterLastListener)
+{
+    Signal<std::string> signal;
+    std::vector<std::string> received;
+
+    std::vector<Connection> connections;
+    for (int i = 0; i < 3; ++i) {
+        connections.emplace_back(signal.connect([&](std::string value) {
+            received.push_back(std::move(value));
+        }));
+    }
+
+    ManualExecutor executor;
+    int finished = 0;
+
+    auto completion = signal.invokeAsync(std::ref(executor), "buffer");
+    completion.then([&] {
+        ++finished;
+    });
+
+    ASSERT_EQ(executor.tasks.size(), 3);
+    EXPECT_FALSE(completion.isDone());
+
+    executor.runOne();
+    executor.runOne();
+    EXPECT_FALSE(completion.isDone());
+    EXPECT_EQ(finished, 0);
+
+    executor.runOne();
+    EXPECT_TRUE(completion.isDone());
+    EXPECT_EQ(finished, 1);
+
+    // Every listener got its own copy of the shared arguments
+    EXPECT_EQ(received, (std::vector<std::string>(3, "buffer")));
+
+    // Already done, called right away
+    completion.then([&] {
+        ++finished;
+    });
+    EXPECT_EQ(finished, 2);
+}
+
+TEST(InvokeCompletion, SeveralContinuations)
+{
+    NoArgSignal signal;
+    auto c1 = signal.connect([] {});
+
+    ManualExecutor executor;
+    std::vector<int> order;
+
+    auto completion = signal.invokeAsync(std::ref(executor));
+    completion.then([&order] {
+        order.push_back(1);
+    });
+
+    // A copy of the handle refers to the same invoke
+    auto copy = completion;
+    copy.then([&order] {
+        order.push_back(2);
+    });
+    completion.then([&order] {
+        order.push_back(3);
+    });
+    EXPECT_TRUE(order.empty());
+
+    executor.runAll();
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(InvokeCompletion, SkipsListenersDisconnectedBeforeTheirTurn)
+{
+    NoArgSignal signal;
+    int calls = 0;
+
+    auto c1 = signal.connect([&calls] {
+        ++calls;
+    });
+    auto c2 = signal.connect([&calls] {
+        ++calls;
+    });
+
+    ManualExecutor executor;
+    auto completion = signal.invokeAsync(std::ref(executor));
+    ASSERT_EQ(executor.tasks.size(), 2);
+
+    c2.disconnect();
+    executor.runAll();
+
+    EXPECT_EQ(calls, 1);
+    EXPECT_TRUE(completion.isDone());
+}
+
+TEST(InvokeCompletion, OutlivesSignal)
+{
+    ManualExecutor executor;
+    InvokeCompletion completion;
+
+    {
+        Signal<int> signal;
+        auto c1 = signal.connect([](int) {});
+
+        completion = signal.invokeAsync(std::ref(executor), 1);
+    }
+
+    // The listener's signal is gone, its task doesn't call it anymore
+    executor.runAll();
+    EXPECT_TRUE(completion.isDone());
+}
+
+TEST(InvokeCompletion, DroppedTask)
+{
+    Signal<int> signal;
+    int calls = 0;
+    auto c1 = signal.connect([&calls](int) {
+        ++calls;
+    });
+    auto c2 = signal.connect([&calls](int) {
+        ++calls;
+    });
+
+    ManualExecutor executor;
+    auto completion = signal.invokeAsync(std::ref(executor), 1);
+    ASSERT_EQ(executor.tasks.size(), 2);
+
+    // An executor shutting down without running its queue still completes
+    // the invoke
+    executor.runOne();
+    executor.tasks.clear();
+
+    EXPECT_EQ(calls, 1);
+    EXPECT_TRUE(completion.isDone());
+    completion.wait();
+}
+
+#if PAJLADA_SIGNALS_EXCEPTIONS
+TEST(InvokeCompletion, ThrowingExecutor)
+{
+    Signal<int> signal;
+    int calls = 0;
+    auto c1 = signal.connect([&calls](int) {
+        ++calls;
+    });
+
+    InvokeCompletion completion;
+    bool doneCalled = false;
+
+    EXPECT_THROW(
+        {
+            completion = signal.invokeAsync(
+                [](auto) {
+                    throw std::runtime_error("queue is full");
+                },
+                1);
+        },
+        std::runtime_error);
+
+    EXPECT_EQ(calls, 0);
+    EXPECT_TRUE(completion.isDone());
+
+    // The signal keeps working afterwards
+    completion = signal.invokeAsync(
+        [](auto task) {
+            task();
+        },
+        1);
+    completion.then([&doneCalled] {
+        doneCalled = true;
+    });
+
+    EXPECT_EQ(calls, 1);
+    EXPECT_TRUE(doneCalled);
+}
+#endif
+
+TEST(InvokeCompletion, BlockedSignal)
+{
+    NoArgSignal signal;
+    auto c1 = signal.connect([] {});
+
+    signal.block();
+
+    ManualExecutor executor;
+    auto completion = signal.invokeAsync(std::ref(executor));
+    EXPECT_TRUE(executor.tasks.empty());
+    EXPECT_TRUE(completion.isDone());
+}
+
+TEST(InvokeCompletion, ThreadPool)
+{
+    Signal<int> signal;
+    std::atomic<int> sum{0};
+
+    std::vector<Connection> connections;
+    for (int i = 0; i < 20; ++i) {
+        connections.emplace_back(signal.connect([&sum](int value) {
+            sum.fetch_add(value, std::memory_order_relaxed);
+        }));
+    }
+
+    ThreadPool pool(4);
+    auto post = [&pool](auto task) {
+        pool.post(std::move(task));
+    };
+
+    std::vector<InvokeCompletion> completions;
+    std::atomic<int> continuations{0};
+    for (int i = 0; i < 100; ++i) {
+        completions.emplace_back(signal.invokeAsync(post, 1));
+        completions.back().then([&continuations] {
+            continuations.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+
+    for (auto &completion : completions) {
+        completion.wait();
+        EXPECT_TRUE(completion.isDone());
+    }
+
+    EXPECT_EQ(sum.load(), 2000);
+
+    // The last continuation may still be running on a pool thread
+    while (continuations.load() != 100) {
+        std::this_thread::yield();
+    }
+}
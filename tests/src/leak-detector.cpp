@@ -0,0 +1,304 @@
+#include <pajlada/signals/broadcast-signal.hpp>
+#include <pajlada/signals/compact-signal.hpp>
+#include <pajlada/signals/dense-signal.hpp>
+#include <pajlada/signals/event-bus.hpp>
+#include <pajlada/signals/leak-detector.hpp>
+#include <pajlada/signals/operators.hpp>
+#include <pajlada/signals/signal.hpp>
+#include <pajlada/signals/sharded-signal.hpp>
+#include <pajlada/signals/signalholder.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <tuple>
+
+using namespace pajlada::Signals;
+
+TEST(LeakDetector, ConnectWithCallSite)
+{
+    // Compiles and behaves the same with and without the leak detector
+    int a = 0;
+    Signal<int> signal;
+    SignalHolder holder;
+
+    auto connection = signal.connect(
+        [&a](int value) {
+            a += value;
+        },
+        0, CallSite::tagged("ConnectWithCallSite"));
+    holder.managedConnect(signal, [&a](int value) {
+        a += value;
+    });
+
+    signal.invoke(2);
+
+    EXPECT_EQ(a, 4);
+}
+
+#if PAJLADA_SIGNALS_LEAK_DETECTOR
+
+namespace {
+
+std::size_t
+countAt(const std::string &location)
+{
+    for (const auto &site : LeakDetector::instance().getCallSiteCounts()) {
+        if (site.location == location) {
+            return site.bodyCount;
+        }
+    }
+
+    return 0;
+}
+
+std::string
+locationOf(int line)
+{
+    return std::string(__FILE__) + ":" + std::to_string(line);
+}
+
+// Number of registered signals reported as created at location
+std::size_t
+countSignalsCreatedAt(const std::string &location)
+{
+    std::size_t count = 0;
+
+    for (const auto &signal : LeakDetector::instance().checkGrowth(0)) {
+        if (signal.createdAt == location) {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+}  // namespace
+
+TEST(LeakDetector, GroupsBodiesByCallSite)
+{
+    Signal<int> signal;
+    Connection connections[3];
+
+    int line = 0;
+    for (auto &connection : connections) {
+        line = __LINE__ + 1;
+        connection = signal.connect([](int) {});
+    }
+
+    EXPECT_EQ(countAt(locationOf(line)), 3);
+}
+
+TEST(LeakDetector, TaggedCallSite)
+{
+    Signal<int> signal;
+
+    auto a = signal.connect([](int) {}, 0, CallSite::tagged("tagged-a"));
+    auto b = signal.connect([](int) {}, 0, CallSite::tagged("tagged-a"));
+    auto c = signal.connect([](int) {}, 0, CallSite::tagged("tagged-b"));
+
+    EXPECT_EQ(countAt("tagged-a"), 2);
+    EXPECT_EQ(countAt("tagged-b"), 1);
+}
+
+TEST(LeakDetector, ManagedConnectRecordsCaller)
+{
+    Signal<int> signal;
+    SignalHolder holder;
+
+    auto line = __LINE__ + 1;
+    holder.managedConnect(signal, [](int) {});
+
+    EXPECT_EQ(countAt(locationOf(line)), 1);
+}
+
+TEST(LeakDetector, WrappersRecordCaller)
+{
+    struct Event {
+    };
+
+    CompactSignal<int> compact;
+    EventBus bus;
+    Signal<int> signal;
+
+    auto compactLine = __LINE__ + 1;
+    auto a = compact.connect([](int) {});
+    auto busLine = __LINE__ + 1;
+    auto b = bus.subscribe<Event>([](const Event &) {});
+    auto pipeLine = __LINE__ + 1;
+    auto c = pipe(signal).take(1).connect([](int) {});
+
+    EXPECT_EQ(countAt(locationOf(compactLine)), 1);
+    EXPECT_EQ(countAt(locationOf(busLine)), 1);
+    EXPECT_EQ(countAt(locationOf(pipeLine)), 1);
+}
+
+TEST(LeakDetector, OtherSignalTypesRecordCaller)
+{
+    struct Foo {
+        void
+        onValue(int)
+        {
+        }
+    };
+
+    Foo foo;
+    BroadcastSignal<int> broadcast;
+    ShardedSignal<int> sharded(4);
+    DenseSignal<int> dense;
+    SignalHolder holder;
+
+    auto broadcastLine = __LINE__ + 1;
+    auto a = broadcast.connect([](const auto &) {});
+    auto shardedLine = __LINE__ + 1;
+    auto b = sharded.connect([](int) {});
+    auto denseLine = __LINE__ + 1;
+    auto c = dense.connect([](int) {});
+    auto memberLine = __LINE__ + 1;
+    auto d = dense.connect<&Foo::onValue>(&foo);
+    auto managedLine = __LINE__ + 1;
+    holder.managedConnect(dense, [](int) {});
+
+    EXPECT_EQ(countAt(locationOf(broadcastLine)), 1);
+    EXPECT_EQ(countAt(locationOf(shardedLine)), 1);
+    EXPECT_EQ(countAt(locationOf(denseLine)), 1);
+    EXPECT_EQ(countAt(locationOf(memberLine)), 1);
+    EXPECT_EQ(countAt(locationOf(managedLine)), 1);
+}
+
+TEST(LeakDetector, SignalsRecordWhereTheyWereCreated)
+{
+    struct Event {
+    };
+
+    auto broadcastLine = __LINE__ + 1;
+    BroadcastSignal<int> broadcast;
+    auto shardedLine = __LINE__ + 1;
+    ShardedSignal<int> sharded(4);
+    auto denseLine = __LINE__ + 1;
+    DenseSignal<int> dense;
+    auto busLine = __LINE__ + 1;
+    EventBus bus;
+    CompactSignal<int> compact;
+
+    auto a = bus.subscribe<Event>([](const Event &) {});
+    auto compactLine = __LINE__ + 1;
+    auto b = compact.connect([](int) {});
+
+    EXPECT_EQ(countSignalsCreatedAt(locationOf(broadcastLine)), 1);
+    // The shards are reported together
+    EXPECT_EQ(countSignalsCreatedAt(locationOf(shardedLine)), 1);
+    EXPECT_EQ(countSignalsCreatedAt(locationOf(denseLine)), 1);
+    EXPECT_EQ(countSignalsCreatedAt(locationOf(busLine)), 1);
+    // A CompactSignal only remembers where its storage was created
+    EXPECT_EQ(countSignalsCreatedAt(locationOf(compactLine)), 1);
+}
+
+TEST(LeakDetector, CheckGrowthOfOtherSignalTypes)
+{
+    auto &detector = LeakDetector::instance();
+
+    auto shardedAt = locationOf(__LINE__ + 1);
+    ShardedSignal<int> sharded(4);
+    auto denseAt = locationOf(__LINE__ + 1);
+    DenseSignal<int> dense;
+
+    auto bodiesOf = [&](const std::string &createdAt) -> std::size_t {
+        for (const auto &growing : detector.checkGrowth(0)) {
+            if (growing.createdAt == createdAt) {
+                return growing.bodyCount;
+            }
+        }
+        return 0;
+    };
+
+    std::ignore = sharded.connect([](int) {});
+    std::ignore = sharded.connect([](int) {});
+    std::ignore = dense.connect([](int) {});
+
+    EXPECT_EQ(bodiesOf(shardedAt), 2);
+    EXPECT_EQ(bodiesOf(denseAt), 1);
+}
+
+TEST(LeakDetector, BodiesAreCountedUntilDestroyed)
+{
+    auto signal = std::make_unique<Signal<int>>();
+
+    {
+        auto connection =
+            signal->connect([](int) {}, 0, CallSite::tagged("until-destroyed"));
+        EXPECT_EQ(countAt("until-destroyed"), 1);
+
+        // Disconnected bodies still take up space until they're swept
+        connection.disconnect();
+        EXPECT_EQ(countAt("until-destroyed"), 1);
+    }
+
+    signal->compact();
+    EXPECT_EQ(countAt("until-destroyed"), 0);
+
+    auto forgotten =
+        signal->connect([](int) {}, 0, CallSite::tagged("until-destroyed"));
+    EXPECT_EQ(countAt("until-destroyed"), 1);
+
+    // The Connection keeps its body alive after the signal is gone
+    signal.reset();
+    EXPECT_EQ(countAt("until-destroyed"), 1);
+
+    forgotten = Connection();
+    EXPECT_EQ(countAt("until-destroyed"), 0);
+}
+
+TEST(LeakDetector, CheckGrowth)
+{
+    auto &detector = LeakDetector::instance();
+
+    auto createdAt = locationOf(__LINE__ + 1);
+    Signal<int> signal;
+
+    auto findGrowing = [&](std::size_t minimumStreak) -> std::size_t {
+        for (const auto &growing : detector.checkGrowth(minimumStreak)) {
+            if (growing.createdAt == createdAt) {
+                return growing.growthStreak;
+            }
+        }
+        return 0;
+    };
+
+    // Only compare to what's there right now
+    findGrowing(3);
+
+    // A listener is connected every round but its connection is dropped
+    // without disconnecting it
+    for (std::size_t round = 1; round <= 2; ++round) {
+        std::ignore = signal.connect([](int) {});
+        EXPECT_EQ(findGrowing(3), 0);
+    }
+
+    std::ignore = signal.connect([](int) {});
+    EXPECT_EQ(findGrowing(3), 3);
+
+    // Staying the same breaks the streak
+    EXPECT_EQ(findGrowing(1), 0);
+}
+
+TEST(LeakDetector, Dump)
+{
+    auto createdAt = locationOf(__LINE__ + 1);
+    Signal<int> signal;
+
+    auto connection = signal.connect([](int) {}, 0, CallSite::tagged("dump"));
+
+    std::ostringstream out;
+    LeakDetector::instance().dump(out, 1);
+
+    auto text = out.str();
+    EXPECT_NE(text.find("Listener bodies by call site:"), std::string::npos);
+    EXPECT_NE(text.find("1\tdump\n"), std::string::npos);
+    EXPECT_NE(text.find("created at " + createdAt), std::string::npos);
+}
+
+#endif
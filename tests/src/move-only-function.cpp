@@ -0,0 +1,101 @@
+#include <pajlada/signals/move-only-function.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+#include <string>
+
+using namespace pajlada::Signals;
+
+namespace {
+
+int
+addOne(int v)
+{
+    return v + 1;
+}
+
+}  // namespace
+
+TEST(MoveOnlyFunction, Empty)
+{
+    MoveOnlyFunction<void()> f;
+    EXPECT_FALSE(f);
+
+    MoveOnlyFunction<void()> g(nullptr);
+    EXPECT_FALSE(g);
+
+    int (*nullFunction)(int) = nullptr;
+    MoveOnlyFunction<int(int)> h(nullFunction);
+    EXPECT_FALSE(h);
+}
+
+TEST(MoveOnlyFunction, FunctionPointer)
+{
+    MoveOnlyFunction<int(int)> f(&addOne);
+    ASSERT_TRUE(f);
+    EXPECT_EQ(f(1), 2);
+}
+
+TEST(MoveOnlyFunction, UniqueCapture)
+{
+    auto value = std::make_unique<int>(5);
+    MoveOnlyFunction<int()> f([value = std::move(value)] {
+        return *value;
+    });
+    ASSERT_TRUE(f);
+    EXPECT_EQ(f(), 5);
+
+    auto moved = std::move(f);
+    EXPECT_FALSE(f);
+    ASSERT_TRUE(moved);
+    EXPECT_EQ(moved(), 5);
+}
+
+TEST(MoveOnlyFunction, LargeCapture)
+{
+    std::array<int, 64> values{};
+    values[63] = 7;
+    auto owned = std::make_unique<int>(3);
+
+    MoveOnlyFunction<int(int)> f(
+        [values, owned = std::move(owned)](int multiplier) {
+            return values[63] * *owned * multiplier;
+        });
+    EXPECT_EQ(f(2), 42);
+
+    MoveOnlyFunction<int(int)> g;
+    g = std::move(f);
+    EXPECT_FALSE(f);
+    EXPECT_EQ(g(1), 21);
+
+    g = nullptr;
+    EXPECT_FALSE(g);
+}
+
+TEST(MoveOnlyFunction, DestroysCallable)
+{
+    auto shared = std::make_shared<int>(1);
+    std::weak_ptr<int> weak(shared);
+
+    {
+        MoveOnlyFunction<void()> f([shared = std::move(shared)] {});
+        EXPECT_FALSE(weak.expired());
+    }
+
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST(MoveOnlyFunction, DiscardsReturnValue)
+{
+    int calls = 0;
+    MoveOnlyFunction<void(const std::string &)> f(
+        [&calls](const std::string &s) {
+            ++calls;
+            return s.size();
+        });
+
+    f("forsen");
+    EXPECT_EQ(calls, 1);
+}
@@ -0,0 +1,234 @@
+#include <pajlada/signals/compact-signal.hpp>
+#include <pajlada/signals/operators.hpp>
+#include <pajlada/signals/scoped-connection.hpp>
+#include <pajlada/signals/signal.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace pajlada::Signals;
+
+TEST(Operators, Map)
+{
+    Signal<int> signal;
+    std::vector<std::string> received;
+
+    auto conn = pipe(signal)
+                    .map([](int v) {
+                        return std::to_string(v * 2);
+                    })
+                    .connect([&](const std::string &s) {
+                        received.push_back(s);
+                    });
+
+    signal.invoke(1);
+    signal.invoke(21);
+    EXPECT_EQ(received, (std::vector<std::string>{"2", "42"}));
+}
+
+TEST(Operators, MapMultipleArguments)
+{
+    Signal<int, int> signal;
+    std::vector<int> received;
+
+    auto conn = pipe(signal)
+                    .map([](int a, int b) {
+                        return a + b;
+                    })
+                    .connect([&](int sum) {
+                        received.push_back(sum);
+                    });
+
+    signal.invoke(1, 2);
+    signal.invoke(3, 4);
+    EXPECT_EQ(received, (std::vector<int>{3, 7}));
+}
+
+TEST(Operators, Filter)
+{
+    Signal<int> signal;
+    std::vector<int> received;
+
+    auto conn = pipe(signal)
+                    .filter([](int v) {
+                        return v % 2 == 0;
+                    })
+                    .connect([&](int v) {
+                        received.push_back(v);
+                    });
+
+    for (int i = 0; i < 6; ++i) {
+        signal.invoke(i);
+    }
+    EXPECT_EQ(received, (std::vector<int>{0, 2, 4}));
+}
+
+TEST(Operators, Take)
+{
+    Signal<int> signal;
+    std::vector<int> received;
+
+    auto conn = pipe(signal).take(2).connect([&](int v) {
+        received.push_back(v);
+    });
+
+    for (int i = 0; i < 5; ++i) {
+        signal.invoke(i);
+    }
+    EXPECT_EQ(received, (std::vector<int>{0, 1}));
+}
+
+TEST(Operators, TakeDisconnectsWhenUsedUp)
+{
+    Signal<int> signal;
+    int calls = 0;
+
+    auto conn = pipe(signal).take(2).connect([&](int) {
+        ++calls;
+    });
+    EXPECT_EQ(signal.getListenerCount(), 1);
+
+    signal.invoke(1);
+    EXPECT_TRUE(conn.isConnected());
+
+    signal.invoke(2);
+    EXPECT_FALSE(conn.isConnected());
+    EXPECT_EQ(signal.getListenerCount(), 0);
+
+    signal.invoke(3);
+    EXPECT_EQ(calls, 2);
+}
+
+TEST(Operators, Distinct)
+{
+    Signal<int, std::string> signal;
+    int calls = 0;
+
+    auto conn = pipe(signal).distinct().connect([&](int, const std::string &) {
+        ++calls;
+    });
+
+    signal.invoke(1, "a");
+    signal.invoke(1, "a");
+    signal.invoke(1, "b");
+    signal.invoke(2, "b");
+    signal.invoke(2, "b");
+    signal.invoke(1, "a");
+    EXPECT_EQ(calls, 4);
+}
+
+TEST(Operators, Scan)
+{
+    Signal<int> signal;
+    std::vector<int> received;
+
+    auto conn = pipe(signal)
+                    .scan(0,
+                          [](int sum, int v) {
+                              return sum + v;
+                          })
+                    .connect([&](int sum) {
+                        received.push_back(sum);
+                    });
+
+    signal.invoke(1);
+    signal.invoke(2);
+    signal.invoke(3);
+    EXPECT_EQ(received, (std::vector<int>{1, 3, 6}));
+}
+
+TEST(Operators, FusedIntoOneListener)
+{
+    Signal<int> signal;
+    std::vector<std::string> received;
+
+    auto conn = pipe(signal)
+                    .filter([](int v) {
+                        return v > 0;
+                    })
+                    .map([](int v) {
+                        return v / 2;
+                    })
+                    .distinct()
+                    .scan(std::string(),
+                          [](std::string text, int v) {
+                              return text + std::to_string(v);
+                          })
+                    .take(3)
+                    .connect([&](const std::string &text) {
+                        received.push_back(text);
+                    });
+
+    EXPECT_EQ(signal.getListenerCount(), 1);
+
+    for (int v : {-2, 2, 3, 4, 5, 0, 6, 8}) {
+        signal.invoke(v);
+    }
+    EXPECT_EQ(received, (std::vector<std::string>{"1", "12", "123"}));
+
+    // The take at the end is used up
+    EXPECT_FALSE(conn.isConnected());
+    EXPECT_EQ(signal.getListenerCount(), 0);
+}
+
+TEST(Operators, StopPropagation)
+{
+    Signal<int> signal;
+    int calls = 0;
+
+    auto stopper = pipe(signal)
+                       .filter([](int v) {
+                           return v == 1;
+                       })
+                       .connect([](int) {
+                           return Propagation::Stop;
+                       });
+    auto counter = signal.connect([&](int) {
+        ++calls;
+    });
+
+    // Values the filter drops don't stop anything
+    signal.invoke(0);
+    EXPECT_EQ(calls, 1);
+
+    signal.invoke(1);
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(Operators, MoveOnlyOperators)
+{
+    Signal<int> signal;
+    int received = 0;
+
+    auto offset = std::make_unique<int>(10);
+    ScopedConnection conn(pipe(signal)
+                              .map([offset = std::move(offset)](int v) {
+                                  return v + *offset;
+                              })
+                              .connect([&](int v) {
+                                  received = v;
+                              }));
+
+    signal.invoke(5);
+    EXPECT_EQ(received, 15);
+}
+
+TEST(Operators, OtherSignalTypes)
+{
+    CompactSignal<int> signal;
+    int received = 0;
+
+    auto conn = pipe(signal)
+                    .map([](int v) {
+                        return v * 3;
+                    })
+                    .connect([&](int v) {
+                        received = v;
+                    });
+
+    signal.invoke(2);
+    EXPECT_EQ(received, 6);
+}
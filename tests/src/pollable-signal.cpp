@@ -0,0 +1,130 @@
+#include <pajlada/signals/pollable-signal.hpp>
+
+#if defined(__linux__)
+
+#include <gtest/gtest.h>
+#include <poll.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pajlada::Signals;
+
+namespace {
+
+bool
+isReadable(int fd, int timeoutMs = 0)
+{
+    pollfd pfd{fd, POLLIN, 0};
+    return poll(&pfd, 1, timeoutMs) == 1 && (pfd.revents & POLLIN) != 0;
+}
+
+}  // namespace
+
+TEST(PollableSignal, DrainInOrder)
+{
+    PollableSignal<int, std::string> signal;
+    ASSERT_GE(signal.getFd(), 0);
+    EXPECT_FALSE(isReadable(signal.getFd()));
+
+    signal.invoke(1, "a");
+    signal.invoke(2, "b");
+    EXPECT_TRUE(isReadable(signal.getFd()));
+    EXPECT_FALSE(signal.isEmpty());
+
+    std::vector<int> numbers;
+    std::vector<std::string> strings;
+    auto drained = signal.drain([&](int n, std::string s) {
+        numbers.push_back(n);
+        strings.push_back(std::move(s));
+    });
+
+    EXPECT_EQ(drained, 2);
+    EXPECT_EQ(numbers, (std::vector<int>{1, 2}));
+    EXPECT_EQ(strings, (std::vector<std::string>{"a", "b"}));
+    EXPECT_FALSE(isReadable(signal.getFd()));
+    EXPECT_TRUE(signal.isEmpty());
+
+    EXPECT_EQ(signal.drain([](int, const std::string &) {}), 0);
+}
+
+TEST(PollableSignal, WakesOncePerBurst)
+{
+    NoArgPollableSignal signal;
+
+    for (int i = 0; i < 10; ++i) {
+        signal.invoke();
+    }
+
+    // Only the first invoke of the burst wrote to the eventfd
+    uint64_t counter = 0;
+    ASSERT_EQ(read(signal.getFd(), &counter, sizeof(counter)),
+              sizeof(counter));
+    EXPECT_EQ(counter, 1);
+
+    EXPECT_EQ(signal.drain([] {}), 10);
+
+    // The queue is empty again, so the next invoke wakes the consumer
+    signal.invoke();
+    EXPECT_TRUE(isReadable(signal.getFd()));
+    EXPECT_EQ(signal.drain([] {}), 1);
+}
+
+TEST(PollableSignal, AdaptsSignal)
+{
+    Signal<int> source;
+    int received = 0;
+
+    {
+        PollableSignal<int> pollable(source);
+
+        source.invoke(5);
+        source.invoke(6);
+        EXPECT_TRUE(isReadable(pollable.getFd()));
+
+        pollable.drain([&](int v) {
+            received += v;
+        });
+        EXPECT_EQ(received, 11);
+        EXPECT_EQ(source.getListenerCount(), 1);
+    }
+
+    EXPECT_EQ(source.getListenerCount(), 0);
+    source.invoke(1);
+}
+
+TEST(PollableSignal, ManyProducers)
+{
+    constexpr int threadCount = 4;
+    constexpr int invokesPerThread = 1000;
+
+    PollableSignal<int> signal;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < invokesPerThread; ++j) {
+                signal.invoke(1);
+            }
+        });
+    }
+
+    int total = 0;
+    while (total < threadCount * invokesPerThread) {
+        ASSERT_TRUE(isReadable(signal.getFd(), 5000));
+        signal.drain([&](int v) {
+            total += v;
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(total, threadCount * invokesPerThread);
+    EXPECT_TRUE(signal.isEmpty());
+}
+
+#endif
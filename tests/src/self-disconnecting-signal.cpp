@@ -2,7 +2,11 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace pajlada::Signals;
 
@@ -67,3 +71,141 @@ TEST(SelfDisconnectingSignal, InvokeOwned)
     signal.invoke(owned);
     EXPECT_TRUE(called);
 }
+
+TEST(SelfDisconnectingSignal, MoveOnlyCallback)
+{
+    SelfDisconnectingSignal<int> signal;
+
+    int result = 0;
+    auto value = std::make_unique<int>(5);
+    signal.connect([&result, value = std::move(value)](int multiplier) {
+        result += *value * multiplier;
+        return result > 10;
+    });
+
+    signal.invoke(1);
+    EXPECT_EQ(result, 5);
+
+    signal.invoke(2);
+    EXPECT_EQ(result, 15);
+
+    signal.invoke(2);
+    EXPECT_EQ(result, 15);
+}
+
+TEST(SelfDisconnectingSignal, ExternalDisconnect)
+{
+    SelfDisconnectingSignal<int> signal;
+
+    int a = 0;
+    auto conn = signal.connect([&](int v) {
+        a += v;
+        return false;
+    });
+
+    signal.invoke(1);
+    EXPECT_EQ(a, 1);
+    EXPECT_TRUE(conn.isConnected());
+
+    EXPECT_TRUE(conn.block());
+    signal.invoke(1);
+    EXPECT_EQ(a, 1);
+    EXPECT_TRUE(conn.unblock());
+
+    EXPECT_TRUE(conn.disconnect());
+    signal.invoke(1);
+    EXPECT_EQ(a, 1);
+    EXPECT_EQ(signal.getListenerCount(), 0);
+}
+
+TEST(SelfDisconnectingSignal, ConnectionReflectsSelfDisconnect)
+{
+    NoArgSelfDisconnectingSignal signal;
+
+    auto conn = signal.connect([] {
+        return true;
+    });
+    EXPECT_TRUE(conn.isConnected());
+    EXPECT_EQ(signal.getListenerCount(), 1);
+
+    signal.invoke();
+    EXPECT_FALSE(conn.isConnected());
+    EXPECT_EQ(signal.getListenerCount(), 0);
+
+    // Disconnecting an already self-disconnected callback is harmless
+    conn.disconnect();
+    EXPECT_EQ(signal.getListenerCount(), 0);
+}
+
+TEST(SelfDisconnectingSignal, ConnectWhileInvoking)
+{
+    NoArgSelfDisconnectingSignal signal;
+
+    int a = 0;
+    int b = 0;
+    signal.connect([&] {
+        ++a;
+        signal.connect([&] {
+            ++b;
+            return true;
+        });
+        return true;
+    });
+
+    signal.invoke();
+    EXPECT_EQ(a, 1);
+    EXPECT_EQ(b, 0);
+
+    signal.invoke();
+    EXPECT_EQ(a, 1);
+    EXPECT_EQ(b, 1);
+
+    signal.invoke();
+    EXPECT_EQ(b, 1);
+}
+
+TEST(SelfDisconnectingSignal, DisconnectBeforeTurn)
+{
+    NoArgSelfDisconnectingSignal signal;
+
+    int b = 0;
+    Connection second;
+    signal.connect([&] {
+        second.disconnect();
+        return false;
+    });
+    second = signal.connect([&] {
+        ++b;
+        return false;
+    });
+
+    // Called in place, so the second listener is already gone by its turn
+    signal.invoke();
+    EXPECT_EQ(b, 0);
+    EXPECT_EQ(signal.getListenerCount(), 1);
+}
+
+TEST(SelfDisconnectingSignal, ConcurrentInvoke)
+{
+    NoArgSelfDisconnectingSignal signal;
+
+    for (int i = 0; i < 100; ++i) {
+        signal.connect([calls = std::make_unique<std::atomic<int>>(0)] {
+            return ++*calls >= 3;
+        });
+    }
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < 100; ++j) {
+                signal.invoke();
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(signal.getListenerCount(), 0);
+}
@@ -0,0 +1,135 @@
+#include <pajlada/signals/scoped-connection.hpp>
+#include <pajlada/signals/sharded-signal.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace pajlada::Signals;
+
+TEST(ShardedSignal, ShardCount)
+{
+    EXPECT_EQ(ShardedSignal<int>(1).getShardCount(), 1);
+    EXPECT_EQ(ShardedSignal<int>(3).getShardCount(), 4);
+    EXPECT_EQ(ShardedSignal<int>(8).getShardCount(), 8);
+    EXPECT_GE(ShardedSignal<int>().getShardCount(), 1);
+}
+
+TEST(ShardedSignal, ConnectDisconnect)
+{
+    ShardedSignal<int> incrementSignal(4);
+    int a = 0;
+    auto IncrementA = [&a](int incrementBy) {
+        a += incrementBy;  //
+    };
+
+    auto connA = incrementSignal.connect(IncrementA);
+    auto connB = incrementSignal.connect(IncrementA);
+    EXPECT_EQ(incrementSignal.getListenerCount(), 2);
+
+    incrementSignal.invoke(1);
+    EXPECT_EQ(a, 2);
+
+    EXPECT_TRUE(connA.disconnect());
+    incrementSignal.invoke(1);
+    EXPECT_EQ(a, 3);
+
+    {
+        ScopedConnection scoped(incrementSignal.connect(IncrementA));
+        incrementSignal.invoke(1);
+        EXPECT_EQ(a, 5);
+    }
+
+    incrementSignal.invoke(1);
+    EXPECT_EQ(a, 6);
+    EXPECT_EQ(incrementSignal.getListenerCount(), 1);
+}
+
+TEST(ShardedSignal, StopPropagation)
+{
+    ShardedSignal<int> signal(4);
+    int calls = 0;
+
+    auto stopping = signal.connect([&calls](int) {
+        ++calls;
+        return Propagation::Stop;
+    });
+    auto skipped = signal.connect([&calls](int) {
+        ++calls;
+    });
+
+    signal.invoke(1);
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(ShardedSignal, ConnectFromManyThreads)
+{
+    constexpr int threadCount = 8;
+    constexpr int connectsPerThread = 100;
+
+    ShardedSignal<int> signal(4);
+    std::atomic<int> sum{0};
+
+    std::vector<std::vector<Connection>> connections(threadCount);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back([&, i] {
+            for (int j = 0; j < connectsPerThread; ++j) {
+                connections[i].push_back(signal.connect([&](int v) {
+                    sum += v;
+                }));
+            }
+            // Disconnect half of them again
+            for (int j = 0; j < connectsPerThread / 2; ++j) {
+                connections[i][j].disconnect();
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(signal.getListenerCount(),
+              threadCount * connectsPerThread / 2);
+
+    signal.invoke(1);
+    EXPECT_EQ(sum, threadCount * connectsPerThread / 2);
+}
+
+TEST(ShardedSignal, MemoryUsage)
+{
+    ShardedSignal<int> signal(4);
+    std::vector<Connection> connections;
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            auto connection = signal.connect([](int) {});
+
+            std::unique_lock<std::mutex> lock(mutex);
+            connections.push_back(std::move(connection));
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    connections[0].disconnect();
+    connections[1].disconnect();
+
+    auto usage = signal.getMemoryUsage();
+    EXPECT_EQ(usage.liveListeners, 2);
+    EXPECT_EQ(usage.deadListeners, 2);
+    EXPECT_GE(usage.capacity, 4);
+
+    signal.compact();
+
+    usage = signal.getMemoryUsage();
+    EXPECT_EQ(usage.liveListeners, 2);
+    EXPECT_EQ(usage.deadListeners, 0);
+    EXPECT_EQ(usage.capacity, 2);
+}
@@ -0,0 +1,135 @@
+#include <pajlada/signals/signal-blocker.hpp>
+#include <pajlada/signals/signal.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace pajlada::Signals;
+
+TEST(SignalBlocker, BlockSignal)
+{
+    Signal<int> incrementSignal;
+    int a = 0;
+    auto IncrementA = [&a](int incrementBy) {
+        a += incrementBy;  //
+    };
+
+    auto connA = incrementSignal.connect(IncrementA);
+    auto connB = incrementSignal.connect(IncrementA);
+
+    EXPECT_FALSE(incrementSignal.isBlocked());
+    EXPECT_TRUE(incrementSignal.block());
+    EXPECT_TRUE(incrementSignal.isBlocked());
+
+    incrementSignal.invoke(1);
+    EXPECT_EQ(a, 0);
+
+    // Connections themselves are untouched
+    EXPECT_FALSE(connA.isBlocked());
+
+    EXPECT_TRUE(incrementSignal.unblock());
+    EXPECT_FALSE(incrementSignal.isBlocked());
+    EXPECT_FALSE(incrementSignal.unblock());
+
+    incrementSignal.invoke(1);
+    EXPECT_EQ(a, 2);
+}
+
+TEST(SignalBlocker, Nested)
+{
+    Signal<int> incrementSignal;
+    int a = 0;
+    auto conn = incrementSignal.connect([&a](int incrementBy) {
+        a += incrementBy;
+    });
+
+    {
+        SignalBlocker outer(incrementSignal);
+        {
+            SignalBlocker inner(incrementSignal);
+            incrementSignal.invoke(1);
+        }
+
+        EXPECT_TRUE(incrementSignal.isBlocked());
+        incrementSignal.invoke(1);
+        EXPECT_EQ(a, 0);
+    }
+
+    EXPECT_FALSE(incrementSignal.isBlocked());
+    incrementSignal.invoke(1);
+    EXPECT_EQ(a, 1);
+}
+
+TEST(SignalBlocker, ReplayLastSuppressed)
+{
+    Signal<std::string> signal;
+    signal.setReplayOnUnblock(true);
+
+    std::vector<std::string> received;
+    auto conn = signal.connect([&](const std::string &s) {
+        received.push_back(s);
+    });
+
+    {
+        SignalBlocker blocker(signal);
+        signal.invoke("first");
+        signal.invoke("second");
+        signal.invoke("Yes, this is a really long long string!");
+        EXPECT_TRUE(received.empty());
+    }
+
+    ASSERT_EQ(received.size(), 1);
+    EXPECT_EQ(received[0], "Yes, this is a really long long string!");
+
+    // Nothing was suppressed this time, so nothing is replayed
+    {
+        SignalBlocker blocker(signal);
+    }
+    EXPECT_EQ(received.size(), 1);
+}
+
+TEST(SignalBlocker, ReplaySharedArgument)
+{
+    Signal<std::shared_ptr<int>> signal;
+    signal.setReplayOnUnblock(true);
+
+    int value = 0;
+    auto conn = signal.connect([&](const std::shared_ptr<int> &v) {
+        value = *v;
+    });
+
+    signal.block();
+    signal.invoke(std::make_shared<int>(5));
+    EXPECT_EQ(value, 0);
+    signal.unblock();
+    EXPECT_EQ(value, 5);
+}
+
+TEST(SignalBlocker, ReplayReferenceArgument)
+{
+    Signal<const std::string &> signal;
+    signal.setReplayOnUnblock(true);
+
+    std::vector<std::string> received;
+    auto conn = signal.connect([&](const std::string &s) {
+        received.push_back(s);
+    });
+
+    {
+        SignalBlocker blocker(signal);
+
+        // The replay has to keep its own copy, the caller's string is gone
+        // by the time the signal is unblocked
+        {
+            std::string text = "Yes, this is a really long long string!";
+            signal.invoke(text);
+        }
+        EXPECT_TRUE(received.empty());
+    }
+
+    ASSERT_EQ(received.size(), 1);
+    EXPECT_EQ(received[0], "Yes, this is a really long long string!");
+}
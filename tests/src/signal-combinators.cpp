@@ -0,0 +1,282 @@
+#include <pajlada/signals/signal-combinators.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace pajlada::Signals;
+
+TEST(CombineLatest, WaitsForEveryInput)
+{
+    Signal<int> width;
+    Signal<int> height;
+
+    auto latest = combineLatest(width, height);
+
+    std::vector<std::tuple<int, int>> received;
+    auto conn = latest.getSignal().connect(
+        [&received](const std::tuple<int, int> &size) {
+            received.push_back(size);
+        });
+
+    width.invoke(1);
+    width.invoke(2);
+    EXPECT_TRUE(received.empty());
+
+    height.invoke(10);
+    height.invoke(20);
+    width.invoke(3);
+
+    EXPECT_EQ(received, (std::vector<std::tuple<int, int>>{
+                            {2, 10}, {2, 20}, {3, 20}}));
+}
+
+TEST(CombineLatest, ValueTypes)
+{
+    Signal<std::string> name;
+    Signal<int, bool> pair;
+    NoArgSignal ping;
+
+    auto latest = combineLatest(name, pair, ping);
+
+    using Expected =
+        std::tuple<std::string, std::tuple<int, bool>, std::tuple<>>;
+    static_assert(std::is_same_v<decltype(latest)::ValueType, Expected>);
+
+    std::vector<Expected> received;
+    auto conn = latest.getSignal().connect([&received](const Expected &value) {
+        received.push_back(value);
+    });
+
+    ping.invoke();
+    pair.invoke(5, true);
+    name.invoke("forsen");
+    name.invoke("pajlada");
+
+    ASSERT_EQ(received.size(), 2);
+    EXPECT_EQ(std::get<0>(received[0]), "forsen");
+    EXPECT_EQ(std::get<0>(received[1]), "pajlada");
+    EXPECT_EQ(std::get<1>(received[1]), std::make_tuple(5, true));
+}
+
+TEST(CombineLatest, DisconnectsOnDestruction)
+{
+    Signal<int> a;
+    Signal<int> b;
+
+    {
+        auto latest = combineLatest(a, b);
+        EXPECT_EQ(a.getListenerCount(), 1);
+        EXPECT_EQ(b.getListenerCount(), 1);
+    }
+
+    a.invoke(1);
+    b.invoke(1);
+    EXPECT_EQ(a.getListenerCount(), 0);
+    EXPECT_EQ(b.getListenerCount(), 0);
+}
+
+TEST(CombineLatest, Threads)
+{
+    struct Pair {
+        int64_t value;
+        int64_t negated;
+    };
+
+    Signal<Pair> a;
+    Signal<Pair> b;
+
+    auto latest = combineLatest(a, b);
+
+    // Every value read from the seqlock must be one that was written whole
+    std::atomic<int> torn{0};
+    std::atomic<int> calls{0};
+    auto conn =
+        latest.getSignal().connect([&](const std::tuple<Pair, Pair> &pairs) {
+            auto [first, second] = pairs;
+            if (first.value != -first.negated ||
+                second.value != -second.negated) {
+                torn.fetch_add(1, std::memory_order_relaxed);
+            }
+            calls.fetch_add(1, std::memory_order_relaxed);
+        });
+
+    a.invoke({0, 0});
+    b.invoke({0, 0});
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            auto &input = (t % 2 == 0) ? a : b;
+            for (int64_t i = 1; i <= 2000; ++i) {
+                input.invoke({i, -i});
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(calls.load(), 1 + 4 * 2000);
+}
+
+TEST(Zip, PairsInvokesInOrder)
+{
+    Signal<int> numbers;
+    Signal<std::string> names;
+
+    auto zipped = zip(numbers, names);
+
+    std::vector<std::tuple<int, std::string>> received;
+    auto conn = zipped.getSignal().connect(
+        [&received](const std::tuple<int, std::string> &row) {
+            received.push_back(row);
+        });
+
+    numbers.invoke(1);
+    numbers.invoke(2);
+    numbers.invoke(3);
+    EXPECT_TRUE(received.empty());
+
+    names.invoke("a");
+    names.invoke("b");
+
+    EXPECT_EQ(received, (std::vector<std::tuple<int, std::string>>{
+                            {1, "a"}, {2, "b"}}));
+
+    names.invoke("c");
+    names.invoke("d");
+    numbers.invoke(4);
+
+    EXPECT_EQ(received, (std::vector<std::tuple<int, std::string>>{
+                            {1, "a"}, {2, "b"}, {3, "c"}, {4, "d"}}));
+}
+
+TEST(Zip, InvokeInputFromListener)
+{
+    Signal<int> a;
+    Signal<int> b;
+
+    auto zipped = zip(a, b);
+
+    std::vector<std::tuple<int, int>> received;
+    auto conn = zipped.getSignal().connect(
+        [&](const std::tuple<int, int> &row) {
+            received.push_back(row);
+
+            if (std::get<0>(row) < 3) {
+                // Delivered once this listener is done, not recursively
+                a.invoke(std::get<0>(row) + 1);
+                b.invoke(std::get<1>(row) + 1);
+                EXPECT_EQ(received.back(), row);
+            }
+        });
+
+    a.invoke(1);
+    b.invoke(1);
+
+    EXPECT_EQ(received, (std::vector<std::tuple<int, int>>{
+                            {1, 1}, {2, 2}, {3, 3}}));
+}
+
+TEST(Zip, Threads)
+{
+    Signal<int> a;
+    Signal<int> b;
+
+    auto zipped = zip(a, b);
+
+    int rows = 0;
+    int64_t sum = 0;
+    auto conn = zipped.getSignal().connect(
+        [&](const std::tuple<int, int> &row) {
+            // Rows are delivered one at a time
+            ++rows;
+            sum += std::get<0>(row) + std::get<1>(row);
+        });
+
+    std::thread first([&a] {
+        for (int i = 0; i < 5000; ++i) {
+            a.invoke(1);
+        }
+    });
+    std::thread second([&b] {
+        for (int i = 0; i < 5000; ++i) {
+            b.invoke(2);
+        }
+    });
+    first.join();
+    second.join();
+
+    EXPECT_EQ(rows, 5000);
+    EXPECT_EQ(sum, 5000 * 3);
+}
+
+TEST(WhenAll, FiresOnce)
+{
+    NoArgSignal configLoaded;
+    Signal<std::string> authReady;
+    NoArgSignal cacheWarm;
+
+    auto ready = whenAll(configLoaded, authReady, cacheWarm);
+
+    int calls = 0;
+    std::string token;
+    auto conn = ready.getSignal().connect([&](const auto &values) {
+        ++calls;
+        token = std::get<1>(values);
+    });
+
+    configLoaded.invoke();
+    authReady.invoke("first");
+    authReady.invoke("second");
+    EXPECT_EQ(calls, 0);
+    EXPECT_FALSE(ready.isDone());
+
+    cacheWarm.invoke();
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(token, "first");
+    EXPECT_TRUE(ready.isDone());
+
+    configLoaded.invoke();
+    cacheWarm.invoke();
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(WhenAll, Threads)
+{
+    std::vector<std::unique_ptr<NoArgSignal>> inputs;
+    for (int i = 0; i < 4; ++i) {
+        inputs.emplace_back(std::make_unique<NoArgSignal>());
+    }
+
+    for (int round = 0; round < 50; ++round) {
+        auto ready = whenAll(*inputs[0], *inputs[1], *inputs[2], *inputs[3]);
+
+        std::atomic<int> calls{0};
+        auto conn = ready.getSignal().connect([&calls](const auto &) {
+            calls.fetch_add(1, std::memory_order_relaxed);
+        });
+
+        std::vector<std::thread> threads;
+        for (auto &input : inputs) {
+            threads.emplace_back([&input] {
+                for (int i = 0; i < 10; ++i) {
+                    input->invoke();
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        EXPECT_EQ(calls.load(), 1);
+        EXPECT_TRUE(ready.isDone());
+    }
+}
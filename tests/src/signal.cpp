@@ -1,9 +1,15 @@
 #include "pajlada/signals/connection.hpp"
+#include <pajlada/signals/scoped-connection.hpp>
 #include <pajlada/signals/signal.hpp>
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace pajlada::Signals;
 
@@ -88,3 +94,677 @@ TEST(Signal, InvokeOwned)
     signal.invoke(owned);
     EXPECT_TRUE(called);
 }
+
+TEST(Signal, ListenerCount)
+{
+    Signal<int> signal;
+
+    EXPECT_EQ(signal.getListenerCount(), 0);
+
+    auto connA = signal.connect([](int) {});
+    auto connB = signal.connect([](int) {});
+    EXPECT_EQ(signal.getListenerCount(), 2);
+
+    auto connBCopy = connB;
+    EXPECT_EQ(signal.getListenerCount(), 2);
+
+    connA.disconnect();
+    EXPECT_EQ(signal.getListenerCount(), 1);
+
+    connB.disconnect();
+    EXPECT_EQ(signal.getListenerCount(), 1);
+
+    connBCopy.disconnect();
+    EXPECT_EQ(signal.getListenerCount(), 0);
+}
+
+TEST(Signal, FirstConnectLastDisconnectHooks)
+{
+    Signal<int> signal;
+
+    int started = 0;
+    int stopped = 0;
+
+    signal.onFirstConnect([&] {
+        ++started;
+    });
+    signal.onLastDisconnect([&] {
+        ++stopped;
+    });
+
+    auto connA = signal.connect([](int) {});
+    EXPECT_EQ(started, 1);
+    EXPECT_EQ(stopped, 0);
+
+    auto connB = signal.connect([](int) {});
+    EXPECT_EQ(started, 1);
+
+    // Blocking does not count as disconnecting
+    connA.block();
+    connB.block();
+    EXPECT_EQ(stopped, 0);
+
+    connA.disconnect();
+    EXPECT_EQ(stopped, 0);
+
+    connB.disconnect();
+    EXPECT_EQ(started, 1);
+    EXPECT_EQ(stopped, 1);
+
+    {
+        ScopedConnection scoped(signal.connect([](int) {}));
+        EXPECT_EQ(started, 2);
+        EXPECT_EQ(stopped, 1);
+    }
+
+    EXPECT_EQ(started, 2);
+    EXPECT_EQ(stopped, 2);
+}
+
+TEST(Signal, HooksAcrossThreads)
+{
+    Signal<> signal;
+
+    std::atomic<int> running{0};
+    std::atomic<int> transitions{0};
+
+    signal.onFirstConnect([&] {
+        EXPECT_EQ(running.exchange(1), 0);
+        ++transitions;
+    });
+    signal.onLastDisconnect([&] {
+        EXPECT_EQ(running.exchange(0), 1);
+        ++transitions;
+    });
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < 1000; ++j) {
+                auto conn = signal.connect([] {});
+                conn.disconnect();
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(running, 0);
+    EXPECT_EQ(transitions % 2, 0);
+    EXPECT_EQ(signal.getListenerCount(), 0);
+}
+
+TEST(Signal, DisconnectAfterSignalDestroyed)
+{
+    Connection conn;
+    {
+        Signal<int> signal;
+        signal.onLastDisconnect([] {
+            FAIL() << "hook must not outlive the signal";
+        });
+        conn = signal.connect([](int) {});
+    }
+
+    EXPECT_FALSE(conn.disconnect());
+}
+
+TEST(Signal, DisconnectWhileSignalIsDestroyed)
+{
+    for (int i = 0; i < 200; ++i) {
+        auto signal = std::make_unique<Signal<int>>();
+        std::atomic<int> stopped{0};
+        signal->onLastDisconnect([&stopped] {
+            ++stopped;
+        });
+
+        auto conn = signal->connect([](int) {});
+
+        std::thread disconnecting([&conn] {
+            conn.disconnect();
+        });
+        signal.reset();
+        disconnecting.join();
+
+        // Depends on who got there first
+        EXPECT_LE(stopped, 1);
+    }
+}
+
+namespace {
+
+class Counter
+{
+public:
+    void
+    increment(int incrementBy)
+    {
+        this->value += incrementBy;
+    }
+
+    void
+    append(const std::string &s)
+    {
+        this->text += s;
+    }
+
+    int value = 0;
+    std::string text;
+};
+
+}  // namespace
+
+TEST(Signal, MemberConnect)
+{
+    Signal<int> incrementSignal;
+    Counter counter;
+
+    auto conn = incrementSignal.connect<&Counter::increment>(&counter);
+
+    incrementSignal.invoke(1);
+    EXPECT_EQ(counter.value, 1);
+
+    incrementSignal.invoke(2);
+    EXPECT_EQ(counter.value, 3);
+
+    EXPECT_TRUE(conn.block());
+    incrementSignal.invoke(2);
+    EXPECT_EQ(counter.value, 3);
+    EXPECT_TRUE(conn.unblock());
+
+    EXPECT_TRUE(conn.disconnect());
+    incrementSignal.invoke(2);
+    EXPECT_EQ(counter.value, 3);
+
+    Signal<std::string> appendSignal;
+    auto connAppend = appendSignal.connect<&Counter::append>(&counter);
+    appendSignal.invoke("foo");
+    appendSignal.invoke("bar");
+    EXPECT_EQ(counter.text, "foobar");
+}
+
+TEST(Signal, MemberConnectScoped)
+{
+    Signal<int> incrementSignal;
+    Counter counter;
+
+    {
+        ScopedConnection conn(
+            incrementSignal.connect<&Counter::increment>(&counter));
+
+        incrementSignal.invoke(1);
+        EXPECT_EQ(counter.value, 1);
+    }
+
+    incrementSignal.invoke(1);
+    EXPECT_EQ(counter.value, 1);
+}
+
+TEST(Signal, TrackedMemberConnect)
+{
+    Signal<int> incrementSignal;
+    auto counter = std::make_shared<Counter>();
+    std::weak_ptr<Counter> weakCounter(counter);
+
+    auto conn = incrementSignal.connect<&Counter::increment>(counter);
+
+    incrementSignal.invoke(1);
+    EXPECT_EQ(counter->value, 1);
+
+    counter.reset();
+    EXPECT_TRUE(weakCounter.expired());
+
+    // Must not touch the destroyed counter
+    incrementSignal.invoke(1);
+}
+
+TEST(Signal, MoveOnlyCallback)
+{
+    Signal<int> signal;
+
+    int result = 0;
+    auto value = std::make_unique<int>(5);
+    auto conn =
+        signal.connect([&result, value = std::move(value)](int multiplier) {
+            result += *value * multiplier;
+        });
+
+    signal.invoke(1);
+    EXPECT_EQ(result, 5);
+
+    signal.invoke(2);
+    EXPECT_EQ(result, 15);
+}
+
+TEST(Signal, StdFunctionCallback)
+{
+    Signal<int> signal;
+
+    int result = 0;
+    std::function<void(int)> func = [&result](int v) {
+        result += v;
+    };
+    auto conn = signal.connect(func);
+
+    signal.invoke(3);
+    EXPECT_EQ(result, 3);
+}
+
+TEST(Signal, PriorityOrder)
+{
+    Signal<> signal;
+    std::vector<std::string> calls;
+
+    auto connA = signal.connect([&] {
+        calls.push_back("a");
+    });
+    auto connB = signal.connect(
+        [&] {
+            calls.push_back("b");
+        },
+        10);
+    auto connC = signal.connect([&] {
+        calls.push_back("c");
+    });
+    auto connD = signal.connect(
+        [&] {
+            calls.push_back("d");
+        },
+        -5);
+    auto connE = signal.connect(
+        [&] {
+            calls.push_back("e");
+        },
+        10);
+
+    signal.invoke();
+
+    std::vector<std::string> expected{"b", "e", "a", "c", "d"};
+    EXPECT_EQ(calls, expected);
+
+    // Order survives disconnected bodies being swept
+    calls.clear();
+    connE.disconnect();
+    signal.invoke();
+
+    expected = {"b", "a", "c", "d"};
+    EXPECT_EQ(calls, expected);
+}
+
+TEST(Signal, StopPropagation)
+{
+    Signal<int> signal;
+    std::vector<std::string> calls;
+
+    auto validator = signal.connect(
+        [&](int v) {
+            calls.push_back("validator");
+            return v < 0 ? Propagation::Stop : Propagation::Continue;
+        },
+        100);
+    auto expensive = signal.connect([&](int) {
+        calls.push_back("expensive");
+    });
+    // Returning anything but Propagation never stops delivery
+    auto other = signal.connect([&](int) {
+        calls.push_back("other");
+        return true;
+    });
+
+    signal.invoke(1);
+    std::vector<std::string> expected{"validator", "expensive", "other"};
+    EXPECT_EQ(calls, expected);
+
+    calls.clear();
+    signal.invoke(-1);
+    expected = {"validator"};
+    EXPECT_EQ(calls, expected);
+
+    // A blocked listener can't stop propagation
+    calls.clear();
+    validator.block();
+    signal.invoke(-1);
+    expected = {"expensive", "other"};
+    EXPECT_EQ(calls, expected);
+}
+
+namespace {
+
+class Cache
+{
+public:
+    Propagation
+    lookup(int key)
+    {
+        return key == this->cachedKey ? Propagation::Stop
+                                      : Propagation::Continue;
+    }
+
+    int cachedKey = 0;
+};
+
+}  // namespace
+
+TEST(Signal, MemberStopPropagation)
+{
+    Signal<int> signal;
+    Cache cache;
+    cache.cachedKey = 5;
+
+    int misses = 0;
+    auto connCache = signal.connect<&Cache::lookup>(&cache, 1);
+    auto connFetch = signal.connect([&](int) {
+        ++misses;
+    });
+
+    signal.invoke(5);
+    EXPECT_EQ(misses, 0);
+
+    signal.invoke(6);
+    EXPECT_EQ(misses, 1);
+}
+
+TEST(Signal, InPlaceInvoke)
+{
+    Signal<int> incrementSignal;
+    incrementSignal.setEmitStrategy(EmitStrategy::InPlace);
+
+    int a = 0;
+    auto IncrementA = [&a](int incrementBy) {
+        a += incrementBy;  //
+    };
+
+    auto connA = incrementSignal.connect(IncrementA);
+    auto connB = incrementSignal.connect(IncrementA);
+
+    incrementSignal.invoke(1);
+    EXPECT_EQ(a, 2);
+
+    EXPECT_TRUE(connA.disconnect());
+
+    incrementSignal.invoke(1);
+    EXPECT_EQ(a, 3);
+    EXPECT_EQ(incrementSignal.getListenerCount(), 1);
+}
+
+TEST(Signal, InPlaceConnectDuringInvoke)
+{
+    NoArgSignal signal;
+    signal.setEmitStrategy(EmitStrategy::InPlace);
+
+    int outerCalls = 0;
+    int innerCalls = 0;
+    std::vector<Connection> connections;
+
+    auto conn = signal.connect([&] {
+        ++outerCalls;
+        connections.emplace_back(signal.connect([&] {
+            ++innerCalls;
+        }));
+    });
+
+    // Listeners connected during an invoke wait for the next one
+    signal.invoke();
+    EXPECT_EQ(outerCalls, 1);
+    EXPECT_EQ(innerCalls, 0);
+    EXPECT_EQ(signal.getListenerCount(), 2);
+
+    signal.invoke();
+    EXPECT_EQ(outerCalls, 2);
+    EXPECT_EQ(innerCalls, 1);
+    EXPECT_EQ(signal.getListenerCount(), 3);
+}
+
+TEST(Signal, InPlaceDisconnectDuringInvoke)
+{
+    NoArgSignal signal;
+    signal.setEmitStrategy(EmitStrategy::InPlace);
+
+    int firstCalls = 0;
+    int secondCalls = 0;
+    Connection second;
+
+    auto first = signal.connect([&] {
+        ++firstCalls;
+        second.disconnect();
+    });
+    second = signal.connect([&] {
+        ++secondCalls;
+    });
+
+    // A listener disconnected before its turn is not called
+    signal.invoke();
+    EXPECT_EQ(firstCalls, 1);
+    EXPECT_EQ(secondCalls, 0);
+    EXPECT_EQ(signal.getListenerCount(), 1);
+
+    Connection self;
+    self = signal.connect([&] {
+        self.disconnect();
+    });
+
+    signal.invoke();
+    signal.invoke();
+    EXPECT_EQ(firstCalls, 3);
+    EXPECT_EQ(signal.getListenerCount(), 1);
+}
+
+TEST(Signal, SnapshotDisconnectDuringInvoke)
+{
+    NoArgSignal signal;
+
+    int secondCalls = 0;
+    Connection second;
+
+    auto first = signal.connect([&] {
+        second.disconnect();
+    });
+    second = signal.connect([&] {
+        ++secondCalls;
+    });
+
+    // Unlike in place, the snapshot still calls it this time
+    signal.invoke();
+    EXPECT_EQ(secondCalls, 1);
+
+    signal.invoke();
+    EXPECT_EQ(secondCalls, 1);
+}
+
+TEST(Signal, InPlaceNestedInvoke)
+{
+    Signal<int> signal;
+    signal.setEmitStrategy(EmitStrategy::InPlace);
+
+    std::vector<int> calls;
+    std::vector<Connection> connections;
+
+    auto conn = signal.connect([&](int depth) {
+        calls.push_back(depth);
+        if (depth < 3) {
+            connections.emplace_back(signal.connect([&](int) {
+                calls.push_back(-1);
+            }));
+            signal.invoke(depth + 1);
+        }
+    });
+
+    // Every nested invoke sees the listeners connected before it started, the
+    // invokes that were already running don't
+    signal.invoke(1);
+    EXPECT_EQ(calls, (std::vector<int>{1, 2, 3, -1, -1, -1}));
+    EXPECT_EQ(signal.getListenerCount(), 3);
+
+    calls.clear();
+    for (auto &connection : connections) {
+        connection.disconnect();
+    }
+    signal.invoke(3);
+    EXPECT_EQ(calls, (std::vector<int>{3}));
+    EXPECT_EQ(signal.getListenerCount(), 1);
+}
+
+TEST(Signal, InPlaceOverlappingInvokes)
+{
+    Signal<int> signal;
+    signal.setEmitStrategy(EmitStrategy::InPlace);
+
+    std::atomic<bool> shouldPark{true};
+    std::atomic<bool> parked{false};
+    std::atomic<bool> resume{false};
+
+    auto parking = signal.connect([&](int) {
+        if (shouldPark.exchange(false)) {
+            parked = true;
+            while (!resume) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    auto dying = signal.connect([](int) {});
+
+    std::thread other([&] {
+        signal.invoke(1);
+    });
+    while (!parked) {
+        std::this_thread::yield();
+    }
+
+    // The other thread is still inside its invoke, ours starts after the
+    // connect so it has to see the new listener
+    int newCalls = 0;
+    auto added = signal.connect([&newCalls](int) {
+        ++newCalls;
+    });
+    dying.disconnect();
+
+    signal.invoke(2);
+    EXPECT_EQ(newCalls, 1);
+
+    // Nor does the disconnected listener wait for both invokes to be done
+    EXPECT_EQ(signal.getMemoryUsage().deadListeners, 0);
+    EXPECT_EQ(signal.getMemoryUsage().liveListeners, 2);
+
+    resume = true;
+    other.join();
+
+    // The other invoke started before the connect
+    EXPECT_EQ(newCalls, 1);
+}
+
+TEST(Signal, InPlacePriorityAndStop)
+{
+    NoArgSignal signal;
+    signal.setEmitStrategy(EmitStrategy::InPlace);
+
+    std::vector<int> order;
+    std::vector<Connection> connections;
+
+    connections.emplace_back(signal.connect([&] {
+        order.push_back(0);
+        // Inserted ahead of everything once the invoke is done
+        connections.emplace_back(signal.connect(
+            [&] {
+                order.push_back(2);
+                return Propagation::Stop;
+            },
+            2));
+    }));
+    connections.emplace_back(signal.connect(
+        [&] {
+            order.push_back(1);
+        },
+        1));
+
+    signal.invoke();
+    EXPECT_EQ(order, (std::vector<int>{1, 0}));
+
+    order.clear();
+    signal.invoke();
+    EXPECT_EQ(order, (std::vector<int>{2}));
+}
+
+TEST(Signal, MemoryUsage)
+{
+    NoArgSignal signal;
+
+    auto empty = signal.getMemoryUsage();
+    EXPECT_EQ(empty.liveListeners, 0);
+    EXPECT_EQ(empty.deadListeners, 0);
+    EXPECT_EQ(empty.capacity, 0);
+    EXPECT_EQ(empty.estimatedBytes, sizeof(signal));
+
+    std::vector<Connection> connections;
+    for (int i = 0; i < 10; ++i) {
+        connections.emplace_back(signal.connect([] {}));
+    }
+    connections[0].block();
+
+    for (int i = 0; i < 4; ++i) {
+        connections[i].disconnect();
+    }
+
+    // Disconnected listeners stay stored until something sweeps them
+    auto usage = signal.getMemoryUsage();
+    EXPECT_EQ(usage.liveListeners, 6);
+    EXPECT_EQ(usage.deadListeners, 4);
+    EXPECT_GE(usage.capacity, 10);
+    EXPECT_GT(usage.estimatedBytes, empty.estimatedBytes + 10 * sizeof(void *));
+
+    signal.invoke();
+
+    usage = signal.getMemoryUsage();
+    EXPECT_EQ(usage.liveListeners, 6);
+    EXPECT_EQ(usage.deadListeners, 0);
+}
+
+TEST(Signal, Compact)
+{
+    Signal<int> signal;
+
+    std::vector<Connection> connections;
+    for (int i = 0; i < 100; ++i) {
+        connections.emplace_back(signal.connect([](int) {}));
+    }
+
+    auto full = signal.getMemoryUsage();
+
+    for (int i = 0; i < 98; ++i) {
+        connections[i].disconnect();
+    }
+
+    signal.compact();
+
+    auto compacted = signal.getMemoryUsage();
+    EXPECT_EQ(compacted.liveListeners, 2);
+    EXPECT_EQ(compacted.deadListeners, 0);
+    EXPECT_EQ(compacted.capacity, 2);
+    EXPECT_LT(compacted.estimatedBytes, full.estimatedBytes);
+
+    int calls = 0;
+    connections.emplace_back(signal.connect([&calls](int) {
+        ++calls;
+    }));
+    signal.invoke(1);
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(Signal, CompactDuringInPlaceInvoke)
+{
+    NoArgSignal signal;
+    signal.setEmitStrategy(EmitStrategy::InPlace);
+
+    Connection first;
+    Connection second = signal.connect([] {});
+    first = signal.connect([&] {
+        second.disconnect();
+
+        // The invoke keeps walking the old storage, the signal moves on to a
+        // compacted one right away
+        signal.compact();
+        EXPECT_EQ(signal.getMemoryUsage().deadListeners, 0);
+    });
+
+    signal.invoke();
+    EXPECT_EQ(signal.getMemoryUsage().deadListeners, 0);
+}
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
+
 using namespace pajlada::Signals;
 
 TEST(SignalHolder, AddConnection)
@@ -95,3 +97,251 @@ TEST(SignalHolder, Clear)
     incrementSignal.invoke(1);
     EXPECT_EQ(a, 4);
 }
+
+namespace {
+
+class View
+{
+public:
+    explicit View(Signal<int> &signal)
+    {
+        this->holder.managedConnect<&View::onIncrement>(signal, this);
+    }
+
+    void
+    onIncrement(int incrementBy)
+    {
+        this->total += incrementBy;
+    }
+
+    int total = 0;
+
+private:
+    SignalHolder holder;
+};
+
+}  // namespace
+
+TEST(SignalHolder, ManagedConnectMember)
+{
+    Signal<int> incrementSignal;
+
+    {
+        View view(incrementSignal);
+
+        incrementSignal.invoke(1);
+        EXPECT_EQ(view.total, 1);
+
+        incrementSignal.invoke(2);
+        EXPECT_EQ(view.total, 3);
+    }
+
+    // The view's holder disconnected, so this must not touch the dead view
+    incrementSignal.invoke(1);
+    EXPECT_EQ(incrementSignal.getListenerCount(), 0);
+}
+
+TEST(SignalHolder, ClearDropsStaleBodies)
+{
+    Signal<int> signalA;
+    Signal<int> signalB;
+    int a = 0;
+    auto IncrementA = [&a](int incrementBy) {
+        a += incrementBy;  //
+    };
+
+    int stopped = 0;
+    signalA.onLastDisconnect([&] {
+        ++stopped;
+    });
+
+    SignalHolder holder;
+    for (int i = 0; i < 1000; ++i) {
+        holder.managedConnect(signalA, IncrementA);
+        holder.managedConnect(signalB, IncrementA);
+    }
+    EXPECT_EQ(signalA.getListenerCount(), 1000);
+
+    signalA.invoke(1);
+    signalB.invoke(1);
+    EXPECT_EQ(a, 2000);
+
+    holder.clear();
+
+    // The listener counts and hooks don't wait for the signal to be invoked
+    EXPECT_EQ(signalA.getListenerCount(), 0);
+    EXPECT_EQ(signalB.getListenerCount(), 0);
+    EXPECT_EQ(stopped, 1);
+
+    // Invoking a signal without listeners doesn't sweep it, so the stale
+    // bodies stay until the signal is compacted or needs room for new ones
+    signalA.invoke(1);
+    EXPECT_EQ(a, 2000);
+    EXPECT_EQ(signalA.getMemoryUsage().deadListeners, 1000);
+    signalA.compact();
+    EXPECT_EQ(signalA.getMemoryUsage().deadListeners, 0);
+    EXPECT_EQ(stopped, 1);
+
+    signalB.invoke(1);
+    EXPECT_EQ(a, 2000);
+    EXPECT_EQ(signalB.getListenerCount(), 0);
+}
+
+TEST(SignalHolder, DestroyFiresLastDisconnect)
+{
+    Signal<int> signal;
+
+    int stopped = 0;
+    signal.onLastDisconnect([&] {
+        ++stopped;
+    });
+
+    Connection other;
+    {
+        SignalHolder holder;
+        holder.managedConnect(signal, [](int) {});
+        other = signal.connect([](int) {});
+        EXPECT_EQ(signal.getListenerCount(), 2);
+    }
+
+    EXPECT_EQ(signal.getListenerCount(), 1);
+    EXPECT_EQ(stopped, 0);
+
+    other.disconnect();
+    EXPECT_EQ(signal.getListenerCount(), 0);
+    EXPECT_EQ(stopped, 1);
+
+    // Reusing the group after clearing it counts from scratch
+    SignalHolder holder;
+    holder.managedConnect(signal, [](int) {});
+    holder.clear();
+    holder.managedConnect(signal, [](int) {});
+    EXPECT_EQ(signal.getListenerCount(), 1);
+    holder.clear();
+    EXPECT_EQ(signal.getListenerCount(), 0);
+    EXPECT_EQ(stopped, 3);
+}
+
+TEST(SignalHolder, MoveAssign)
+{
+    Signal<int> incrementSignal;
+    int a = 0;
+    auto IncrementA = [&a](int incrementBy) {
+        a += incrementBy;  //
+    };
+
+    SignalHolder holder;
+    holder.managedConnect(incrementSignal, IncrementA);
+
+    {
+        SignalHolder other;
+        other.managedConnect(incrementSignal, IncrementA);
+        other.managedConnect(incrementSignal, IncrementA);
+
+        incrementSignal.invoke(1);
+        EXPECT_EQ(a, 3);
+
+        // Our old connection goes away, other's connections are now ours
+        holder = std::move(other);
+
+        incrementSignal.invoke(1);
+        EXPECT_EQ(a, 5);
+    }
+
+    incrementSignal.invoke(1);
+    EXPECT_EQ(a, 7);
+
+    SignalHolder moved(std::move(holder));
+    incrementSignal.invoke(1);
+    EXPECT_EQ(a, 9);
+
+    moved.clear();
+    incrementSignal.invoke(1);
+    EXPECT_EQ(a, 9);
+}
+
+TEST(SignalHolder, OutlivesSignal)
+{
+    SignalHolder holder;
+
+    {
+        Signal<int> incrementSignal;
+        holder.managedConnect(incrementSignal, [](int) {});
+    }
+
+    holder.clear();
+}
+
+TEST(SignalHolder, MemoryUsage)
+{
+    Signal<int> incrementSignal;
+
+    SignalHolder holder;
+    EXPECT_EQ(holder.getMemoryUsage().liveListeners, 0);
+
+    for (int i = 0; i < 5; ++i) {
+        holder.managedConnect(incrementSignal, [](int) {});
+    }
+
+    auto otherSignal = std::make_unique<Signal<int>>();
+    holder.addConnection(otherSignal->connect([](int) {}));
+    holder.addConnection(incrementSignal.connect([](int) {}));
+
+    auto usage = holder.getMemoryUsage();
+    EXPECT_EQ(usage.liveListeners, 7);
+    EXPECT_EQ(usage.deadListeners, 0);
+    EXPECT_GE(usage.capacity, 2);
+    EXPECT_GT(usage.estimatedBytes, sizeof(holder));
+
+    // Disconnects its listeners, the holder still stores the connection
+    otherSignal.reset();
+
+    usage = holder.getMemoryUsage();
+    EXPECT_EQ(usage.liveListeners, 6);
+    EXPECT_EQ(usage.deadListeners, 1);
+
+    holder.compact();
+
+    usage = holder.getMemoryUsage();
+    EXPECT_EQ(usage.liveListeners, 6);
+    EXPECT_EQ(usage.deadListeners, 0);
+    EXPECT_EQ(usage.capacity, 1);
+
+    holder.clear();
+    holder.compact();
+
+    usage = holder.getMemoryUsage();
+    EXPECT_EQ(usage.liveListeners, 0);
+    EXPECT_EQ(usage.capacity, 0);
+    EXPECT_EQ(usage.estimatedBytes, sizeof(holder));
+
+    // Reconnecting after compacting starts a new group
+    int a = 0;
+    holder.managedConnect(incrementSignal, [&a](int incrementBy) {
+        a += incrementBy;  //
+    });
+    incrementSignal.invoke(1);
+    EXPECT_EQ(a, 1);
+    EXPECT_EQ(holder.getMemoryUsage().liveListeners, 1);
+}
+
+TEST(SignalHolder, MemoryUsageAfterSignalDestroyed)
+{
+    SignalHolder holder;
+
+    {
+        Signal<int> signal;
+        for (int i = 0; i < 3; ++i) {
+            holder.managedConnect(signal, [](int) {});
+        }
+        EXPECT_EQ(holder.getMemoryUsage().liveListeners, 3);
+    }
+
+    // The listeners went away with their signal
+    EXPECT_EQ(holder.getMemoryUsage().liveListeners, 0);
+    EXPECT_EQ(holder.getMemoryUsage().deadListeners, 0);
+
+    // Nothing in the group is connected anymore, so compact drops it
+    holder.compact();
+    EXPECT_EQ(holder.getMemoryUsage().estimatedBytes, sizeof(holder));
+}
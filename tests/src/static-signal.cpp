@@ -0,0 +1,113 @@
+#include <pajlada/signals/signal.hpp>
+#include <pajlada/signals/static-signal.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace pajlada::Signals;
+
+namespace {
+
+// Written against the common Signal interface
+template <typename SignalType>
+void
+emitTwice(SignalType &signal, int value)
+{
+    signal.invoke(value);
+    signal.invoke(value * 2);
+}
+
+}  // namespace
+
+TEST(StaticSignal, InvokeInOrder)
+{
+    std::vector<int> calls;
+
+    auto signal = makeStaticSignal<int>(
+        [&](int v) {
+            calls.push_back(v);
+        },
+        [&](int v) {
+            calls.push_back(v + 100);
+        });
+
+    static_assert(decltype(signal)::getListenerCount() == 2);
+
+    signal.invoke(1);
+
+    ASSERT_EQ(calls.size(), 2);
+    EXPECT_EQ(calls[0], 1);
+    EXPECT_EQ(calls[1], 101);
+}
+
+TEST(StaticSignal, Pipeline)
+{
+    int sum = 0;
+    int max = 0;
+    int count = 0;
+
+    auto consumers = makeStaticSignal<int>(
+        [&](int v) {
+            sum += v;
+        },
+        [&](int v) {
+            max = std::max(max, v);
+        },
+        [&](int) {
+            ++count;
+        });
+
+    auto filter = makeStaticSignal<int>([&](int v) {
+        if (v % 2 == 0) {
+            consumers.invoke(v);
+        }
+    });
+
+    for (int i = 0; i < 10; ++i) {
+        filter.invoke(i);
+    }
+
+    EXPECT_EQ(sum, 20);
+    EXPECT_EQ(max, 8);
+    EXPECT_EQ(count, 5);
+}
+
+TEST(StaticSignal, CompatibleWithSignal)
+{
+    int staticTotal = 0;
+    auto staticSignal = makeStaticSignal<int>([&](int v) {
+        staticTotal += v;
+    });
+
+    int dynamicTotal = 0;
+    Signal<int> dynamicSignal;
+    auto conn = dynamicSignal.connect([&](int v) {
+        dynamicTotal += v;
+    });
+
+    emitTwice(staticSignal, 2);
+    emitTwice(dynamicSignal, 2);
+
+    EXPECT_EQ(staticTotal, 6);
+    EXPECT_EQ(dynamicTotal, 6);
+}
+
+TEST(StaticSignal, InvokeOwned)
+{
+    bool called = false;
+    auto signal = makeStaticSignal<std::string>(
+        [&](std::string s) {
+            EXPECT_EQ(s, "Yes, this is a really long long string!");
+            called = true;
+        },
+        [&](const std::string &s) {
+            EXPECT_EQ(s, "Yes, this is a really long long string!");
+            called = true;
+        });
+
+    signal.invoke("Yes, this is a really long long string!");
+    EXPECT_TRUE(called);
+}